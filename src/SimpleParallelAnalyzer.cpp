@@ -3,6 +3,8 @@
 #include <AnalyzerChannelData.h>
 #include <cassert>
 #include <algorithm>
+#include <stdio.h>
+#include <string.h>
 
 SimpleParallelAnalyzer::SimpleParallelAnalyzer()
     : Analyzer2(), mSettings( new SimpleParallelAnalyzerSettings() ), mSimulationInitilized( false )
@@ -51,17 +53,34 @@ void SimpleParallelAnalyzer::WorkerThread()
     }
 
 
-    U32 num_data_lines = mData.size();
+    SetupChannelGroupFields();
+    SetupSequenceMatcher();
+    SetupChecksum();
+
+    // convert the minimum clock pulse width to samples, rounding up.
+    U64 minimum_pulse_samples = ( static_cast<U64>( mSettings->mMinimumClockPulseNs ) * mSampleRateHz + 999999999ull ) / 1000000000ull;
+    mMinimumClockPulseSamples = static_cast<U32>( std::min<U64>( minimum_pulse_samples, 0xFFFFFFFF ) );
+    mGlitchCount = 0;
+
+    // restart the frame stream for every run, so the previous run's queued frames are not mixed in. The consumer sees a new connection,
+    // starting with the new run number.
+    mFrameStream.reset();
+    mRunNumber++;
+    if( !mSettings->mFrameStreamPath.empty() )
+        mFrameStream.reset( new SimpleParallelFrameStream( mSettings->mFrameStreamPath, mRunNumber, mSampleRateHz ) );
+
+    // takes the data words from the previous run's cache while the clock agrees with it, if possible. Otherwise, records a new one.
+    SetupEdgeCache();
 
     if( mSettings->mClockEdge == ParallelAnalyzerClockEdge::NegEdge )
     {
         if( mClock->GetBitState() == BIT_LOW )
-            mClock->AdvanceToNextEdge();
+            AdvanceClockToNextEdge();
     }
     else if( mSettings->mClockEdge == ParallelAnalyzerClockEdge::PosEdge )
     {
         if( mClock->GetBitState() == BIT_HIGH )
-            mClock->AdvanceToNextEdge();
+            AdvanceClockToNextEdge();
     }
     else if( mSettings->mClockEdge == ParallelAnalyzerClockEdge::DualEdge )
     {
@@ -70,7 +89,7 @@ void SimpleParallelAnalyzer::WorkerThread()
         return;
     }
 
-    mClock->AdvanceToNextEdge(); // this is the data-valid edge
+    AdvanceClockToNextEdge(); // this is the data-valid edge
 
     Frame last_frame;
     bool is_first_frame = true;
@@ -83,9 +102,6 @@ void SimpleParallelAnalyzer::WorkerThread()
 
         U16 result = GetWordAtLocation( sample );
 
-        FrameV2 frame_v2;
-        frame_v2.AddInteger( "data", result );
-
         Frame frame;
         frame.mData1 = result;
         frame.mFlags = 0;
@@ -113,28 +129,7 @@ void SimpleParallelAnalyzer::WorkerThread()
             // transitions might show up.
             if( mClock->WouldAdvancingCauseTransition( estimated_frame_size ) )
             {
-                // Move to inactive edge
-                mClock->AdvanceToNextEdge();
-                if( mClock->DoMoreTransitionsExistInCurrentData() )
-                {
-                    // Move to active edge
-                    mClock->AdvanceToNextEdge();
-
-                    frame.mEndingSampleInclusive = mClock->GetSampleNumber() - 1;
-                    mResults->AddFrame( frame );
-                    mResults->AddFrameV2( frame_v2, "data", frame.mStartingSampleInclusive, frame.mEndingSampleInclusive );
-                    mResults->CommitResults();
-                }
-                else
-                {
-                    frame.mEndingSampleInclusive = mClock->GetSampleNumber() - 1;
-                    mResults->AddFrame( frame );
-                    mResults->AddFrameV2( frame_v2, "data", frame.mStartingSampleInclusive, frame.mEndingSampleInclusive );
-                    mResults->CommitResults();
-
-                    // Move to active edge
-                    mClock->AdvanceToNextEdge();
-                }
+                AddFrameAndAdvanceToActiveEdge( frame );
             }
             else
             {
@@ -143,40 +138,18 @@ void SimpleParallelAnalyzer::WorkerThread()
                 {
                     frame.mEndingSampleInclusive = frame.mStartingSampleInclusive + 1;
                 }
-                mResults->AddFrame( frame );
-                mResults->AddFrameV2( frame_v2, "data", frame.mStartingSampleInclusive, frame.mEndingSampleInclusive );
-                mResults->CommitResults();
+                AddFrame( result, frame.mStartingSampleInclusive, frame.mEndingSampleInclusive );
 
                 // Move to inactive edge, and then the active edge
-                mClock->AdvanceToNextEdge();
-                mClock->AdvanceToNextEdge();
+                CloseIdleChecksumRun();
+                AdvanceClockToNextEdge();
+                CloseIdleChecksumRun();
+                AdvanceClockToNextEdge();
             }
         }
         else
         {
-            // Move to inactive edge
-            mClock->AdvanceToNextEdge();
-
-            if( mClock->DoMoreTransitionsExistInCurrentData() )
-            {
-                // Move to active edge
-                mClock->AdvanceToNextEdge();
-
-                frame.mEndingSampleInclusive = mClock->GetSampleNumber() - 1;
-                mResults->AddFrame( frame );
-                mResults->AddFrameV2( frame_v2, "data", frame.mStartingSampleInclusive, frame.mEndingSampleInclusive );
-                mResults->CommitResults();
-            }
-            else
-            {
-                frame.mEndingSampleInclusive = mClock->GetSampleNumber() - 1;
-                mResults->AddFrame( frame );
-                mResults->AddFrameV2( frame_v2, "data", frame.mStartingSampleInclusive, frame.mEndingSampleInclusive );
-                mResults->CommitResults();
-
-                // Move to active edge
-                mClock->AdvanceToNextEdge();
-            }
+            AddFrameAndAdvanceToActiveEdge( frame );
         }
 
         // Note: mClock should always be at an active edge at this point, and `frame` should have been added.
@@ -224,16 +197,21 @@ void SimpleParallelAnalyzer::DecodeBothEdges()
     // If there is another edge, we advance to it and return true.
     // force_advance optionally ensures we advance to the next edge. If there are no more edges in the data, this will never return.
     auto advance_to_next_edge_or_fail = [&]( bool force_advance ) -> bool {
-        if( mClock->DoMoreTransitionsExistInCurrentData() || force_advance )
+        if( force_advance )
         {
-            mClock->AdvanceToNextEdge();
+            AdvanceClockToNextEdge();
             return true;
         }
+        if( mClock->DoMoreTransitionsExistInCurrentData() )
+        {
+            // false if the available data ends in ringing. The clock is then left at the end of it.
+            return TryAdvanceClockToNextEdge();
+        }
         int64_t estimated_frame_size = mLastFrameWidth > 0 ? std::max<int64_t>( static_cast<int64_t>( mLastFrameWidth * 0.1 ), 2 ) : 10;
         if( mClock->WouldAdvancingCauseTransition( estimated_frame_size ) )
         {
             // this condition will only be true if we're very lucky, and we're processing data while recording in real time.
-            mClock->AdvanceToNextEdge();
+            AdvanceClockToNextEdge();
             return true;
         }
         mClock->Advance( estimated_frame_size );
@@ -251,6 +229,10 @@ void SimpleParallelAnalyzer::DecodeBothEdges()
 
     for( ;; )
     {
+        // every decoded word has been added, and the next advance may block waiting for the clock.
+        if( !has_pending_frame )
+            CloseIdleChecksumRun();
+
         // advance to the next active edge.
         auto found_next_edge = advance_to_next_edge_or_fail( !has_pending_frame );
         auto location = mClock->GetSampleNumber();
@@ -279,30 +261,436 @@ void SimpleParallelAnalyzer::DecodeBothEdges()
     }
 }
 
+void SimpleParallelAnalyzer::AddFrameAndAdvanceToActiveEdge( Frame& frame )
+{
+    U16 result = static_cast<U16>( frame.mData1 );
+
+    // Move to inactive edge
+    if( !TryAdvanceClockToNextEdge() )
+    {
+        // the available data ends in ringing before the inactive edge. End the frame before the ringing, and wait for both edges.
+        frame.mEndingSampleInclusive = mLastGlitchSample - 1;
+        AddFrame( result, frame.mStartingSampleInclusive, frame.mEndingSampleInclusive );
+        CloseIdleChecksumRun();
+
+        AdvanceClockToNextEdge();
+        AdvanceClockToNextEdge();
+    }
+    else if( !mClock->DoMoreTransitionsExistInCurrentData() )
+    {
+        frame.mEndingSampleInclusive = mClock->GetSampleNumber() - 1;
+        AddFrame( result, frame.mStartingSampleInclusive, frame.mEndingSampleInclusive );
+        CloseIdleChecksumRun();
+
+        // Move to active edge
+        AdvanceClockToNextEdge();
+    }
+    else if( TryAdvanceClockToNextEdge() ) // Move to active edge
+    {
+        frame.mEndingSampleInclusive = mClock->GetSampleNumber() - 1;
+        AddFrame( result, frame.mStartingSampleInclusive, frame.mEndingSampleInclusive );
+    }
+    else
+    {
+        // the available data ends in ringing before the active edge.
+        frame.mEndingSampleInclusive = mLastGlitchSample - 1;
+        AddFrame( result, frame.mStartingSampleInclusive, frame.mEndingSampleInclusive );
+        CloseIdleChecksumRun();
+
+        AdvanceClockToNextEdge();
+    }
+}
+
+void SimpleParallelAnalyzer::AdvanceClockToNextEdge()
+{
+    while( !TryAdvanceClockToNextEdge() )
+    {
+    }
+}
+
+bool SimpleParallelAnalyzer::TryAdvanceClockToNextEdge()
+{
+    AdvanceClockToNextRawEdge();
+
+    if( mMinimumClockPulseSamples <= 1 )
+        return true;
+
+    // A pulse narrower than the minimum width is ringing, not a clock edge. Skip both of its edges, and then check the pulse that starts
+    // at the edge we land on. Only look ahead into transitions that are already available: at the end of the data,
+    // WouldAdvancingCauseTransition would block until more data arrives, and the frame ending at this edge would never be committed.
+    // So an edge at the end of the data is taken as is.
+    while( mClock->DoMoreTransitionsExistInCurrentData() && mClock->WouldAdvancingCauseTransition( mMinimumClockPulseSamples - 1 ) )
+    {
+        mLastGlitchSample = mClock->GetSampleNumber();
+        mResults->AddMarker( mLastGlitchSample, AnalyzerResults::ErrorX, mSettings->mClockChannel );
+        AdvanceClockToNextRawEdge();
+        mGlitchCount++;
+
+        if( !mClock->DoMoreTransitionsExistInCurrentData() )
+            return false;
+        AdvanceClockToNextRawEdge();
+    }
+    return true;
+}
+
+void SimpleParallelAnalyzer::AdvanceClockToNextRawEdge()
+{
+    mClock->AdvanceToNextEdge();
+    U64 sample = mClock->GetSampleNumber();
+
+    if( mEdgeCacheReplaying )
+    {
+        // every clock transition must match the cache, or the cached line states don't belong to this capture.
+        SimpleParallelEdgeCache::Cursor next = mEdgeCacheCursor;
+        bool cached = mEdgeCache.Read( next );
+        if( cached && next.mSample == sample )
+        {
+            mEdgeCacheCursor = next;
+            return;
+        }
+        StopEdgeCacheReplay( !cached );
+    }
+
+    if( mEdgeCacheLineData.empty() )
+        return;
+
+    U16 line_state = 0;
+    U32 num_lines = mEdgeCacheLineData.size();
+    for( U32 i = 0; i < num_lines; i++ )
+    {
+        AnalyzerChannelData* line_data = mEdgeCacheLineData[ i ];
+
+        // only spot checks advance the lines before this does, and never past an edge of a line whose first edge is unknown. So until a
+        // line passes its first edge, its next edge is the first one.
+        if( mEdgeCache.GetLineFirstEdge( i ) == SimpleParallelEdgeCache::NoEdge && line_data->DoMoreTransitionsExistInCurrentData() )
+            mEdgeCache.SetLineFirstEdge( i, line_data->GetSampleOfNextEdge() );
+
+        line_data->AdvanceToAbsPosition( sample );
+        if( line_data->GetBitState() == BIT_HIGH )
+            line_state |= 1 << i;
+    }
+
+    if( !mEdgeCache.AddTransition( sample, line_state ) )
+        mEdgeCacheLineData.clear(); // the cache is full, keep what we have.
+}
+
+void SimpleParallelAnalyzer::SetupEdgeCache()
+{
+    // only trust the cache when the settings were changed in the dialog since the last run. Otherwise, this run is most likely for a new
+    // capture. Loading saved settings usually comes with a different capture too.
+    bool settings_changed = mSettings->mRevision != mEdgeCacheSettingsRevision;
+    mEdgeCacheSettingsRevision = mSettings->mRevision;
+    if( mSettings->mLoadCount != mEdgeCacheSettingsLoadCount )
+    {
+        mEdgeCacheSettingsLoadCount = mSettings->mLoadCount;
+        mEdgeCache.Clear();
+    }
+    mEdgeCacheLineData.clear();
+    mEdgeCacheReplaying = false;
+
+    if( settings_changed && mEdgeCache.Matches( mSettings->mClockChannel, mDataChannels, mSampleRateHz ) && EdgeCacheMatchesCapture() )
+    {
+        // lookup tables from the cached line state to the data word, one per byte of line state.
+        auto& lines = mEdgeCache.GetLines();
+        memset( mEdgeCacheWordTables, 0, sizeof( mEdgeCacheWordTables ) );
+        for( U32 line = 0; line < lines.size(); line++ )
+        {
+            U16 mask = 0;
+            for( U32 i = 0; i < mDataChannels.size(); i++ )
+            {
+                if( mDataChannels[ i ] == lines[ line ] )
+                    mask |= mDataMasks[ i ];
+            }
+            for( U32 byte = 0; byte < 256; byte++ )
+            {
+                if( byte & ( 1 << ( line % 8 ) ) )
+                    mEdgeCacheWordTables[ line / 8 ][ byte ] |= mask;
+            }
+        }
+
+        mEdgeCacheReplaying = true;
+        mEdgeCacheCursor = SimpleParallelEdgeCache::Cursor();
+        mEdgeCacheWordsRead = 0;
+        return;
+    }
+
+    U16 initial_line_state = 0;
+    for( U32 i = 0; i < mData.size(); i++ )
+    {
+        if( mData[ i ]->GetBitState() == BIT_HIGH )
+            initial_line_state |= 1 << i;
+    }
+    mEdgeCache.Start( mSettings->mClockChannel, mDataChannels, mSampleRateHz, mClock->GetBitState(), initial_line_state );
+    mEdgeCacheLineData = mData;
+}
+
+bool SimpleParallelAnalyzer::EdgeCacheMatchesCapture()
+{
+    // a quick check, without moving any channel, that this is still the capture the cache was recorded from. Replay then compares every
+    // clock transition, and spot checks the data lines.
+    if( mClock->GetBitState() != mEdgeCache.GetInitialClockState() )
+        return false;
+    if( !mClock->DoMoreTransitionsExistInCurrentData() || mClock->GetSampleOfNextEdge() != mEdgeCache.GetFirstSample() )
+        return false;
+
+    auto& lines = mEdgeCache.GetLines();
+    for( U32 line = 0; line < lines.size(); line++ )
+    {
+        auto channel = std::find( mDataChannels.begin(), mDataChannels.end(), lines[ line ] );
+        if( channel == mDataChannels.end() )
+            continue;
+        AnalyzerChannelData* data = mData[ channel - mDataChannels.begin() ];
+
+        BitState initial_state = ( mEdgeCache.GetInitialLineState() & ( 1 << line ) ) != 0 ? BIT_HIGH : BIT_LOW;
+        if( data->GetBitState() != initial_state )
+            return false;
+
+        U64 first_edge = mEdgeCache.GetLineFirstEdge( line );
+        bool has_edge = data->DoMoreTransitionsExistInCurrentData();
+        if( first_edge != SimpleParallelEdgeCache::NoEdge && ( !has_edge || data->GetSampleOfNextEdge() != first_edge ) )
+            return false;
+        if( first_edge == SimpleParallelEdgeCache::NoEdge && has_edge && data->GetSampleOfNextEdge() <= mEdgeCache.GetLastSample() )
+            return false;
+    }
+    return true;
+}
+
+void SimpleParallelAnalyzer::StopEdgeCacheReplay( bool reached_end )
+{
+    mEdgeCacheReplaying = false;
+
+    if( !reached_end )
+    {
+        // this is a different capture after all. Everything decoded so far was checked, so just read the data lines from here on, and
+        // record a new cache on the next run.
+        mEdgeCache.Clear();
+        return;
+    }
+
+    // keep extending the cache, if this run samples exactly the cached lines.
+    auto& lines = mEdgeCache.GetLines();
+    if( lines.size() != mDataChannels.size() )
+        return;
+    for( auto& line : lines )
+    {
+        auto data = std::find( mDataChannels.begin(), mDataChannels.end(), line );
+        mEdgeCacheLineData.push_back( mData[ data - mDataChannels.begin() ] );
+    }
+}
+
+bool SimpleParallelAnalyzer::ReadEdgeCacheWord( U64 sample_number, U16& word )
+{
+    if( mEdgeCacheCursor.mNumTransitions == 0 || mEdgeCacheCursor.mSample != sample_number )
+        return false;
+
+    U16 line_state = mEdgeCacheCursor.mLineState;
+    word = mEdgeCacheWordTables[ 0 ][ line_state & 0xFF ] | mEdgeCacheWordTables[ 1 ][ line_state >> 8 ];
+
+    // reading the data lines only now and then still skips nearly all of their walk. The lines only ever move forward, so decoding can
+    // continue from them if they disagree.
+    if( mEdgeCacheWordsRead++ % EdgeCacheSpotCheckInterval != 0 )
+        return true;
+
+    U16 line_word = 0;
+    for( U32 i = 0; i < mData.size(); i++ )
+    {
+        mData[ i ]->AdvanceToAbsPosition( sample_number );
+        if( mData[ i ]->GetBitState() == BIT_HIGH )
+            line_word |= mDataMasks[ i ];
+    }
+    if( line_word != word )
+    {
+        StopEdgeCacheReplay( false );
+        word = line_word;
+    }
+    return true;
+}
+
 uint16_t SimpleParallelAnalyzer::GetWordAtLocation( uint64_t sample_number )
 {
     uint16_t result = 0;
 
     int num_data_lines = mData.size();
 
-    for( int i = 0; i < num_data_lines; i++ )
+    if( !mEdgeCacheReplaying || !ReadEdgeCacheWord( sample_number, result ) )
     {
-        mData[ i ]->AdvanceToAbsPosition( sample_number );
-        if( mData[ i ]->GetBitState() == BIT_HIGH )
+        for( int i = 0; i < num_data_lines; i++ )
         {
-            result |= mDataMasks[ i ];
+            mData[ i ]->AdvanceToAbsPosition( sample_number );
+            if( mData[ i ]->GetBitState() == BIT_HIGH )
+            {
+                result |= mDataMasks[ i ];
+            }
         }
+    }
+
+    for( int i = 0; i < num_data_lines; i++ )
+    {
         mResults->AddMarker( sample_number, AnalyzerResults::Dot, mDataChannels[ i ] );
     }
 
     return result;
 }
 
+void SimpleParallelAnalyzer::SetupChannelGroupFields()
+{
+    mChannelGroupFields.clear();
+
+    for( auto& group : mSettings->mChannelGroups )
+    {
+        ChannelGroupField field;
+        // group fields get their own namespace, so they can't collide with "data", "glitches", or any other built in field.
+        field.mName = "group." + group.mName;
+
+        // split the group mask into runs of adjacent lines, so extraction costs one shift and mask per run rather than one per line.
+        U8 destination_shift = 0;
+        for( U32 i = 0; i < 16; )
+        {
+            if( ( group.mMask & ( 1 << i ) ) == 0 )
+            {
+                i++;
+                continue;
+            }
+            U32 run_length = 0;
+            while( i + run_length < 16 && ( group.mMask & ( 1 << ( i + run_length ) ) ) != 0 )
+                run_length++;
+
+            ChannelGroupField::BitRun run;
+            run.mSourceShift = i;
+            run.mDestinationShift = destination_shift;
+            run.mMask = static_cast<U16>( ( 1 << run_length ) - 1 );
+            field.mRuns.push_back( run );
+
+            destination_shift += run_length;
+            i += run_length;
+        }
+
+        mChannelGroupFields.push_back( field );
+    }
+}
+
+U16 SimpleParallelAnalyzer::ChannelGroupField::Extract( U16 word ) const
+{
+    U16 result = 0;
+    for( auto& run : mRuns )
+    {
+        result |= ( ( word >> run.mSourceShift ) & run.mMask ) << run.mDestinationShift;
+    }
+    return result;
+}
+
+void SimpleParallelAnalyzer::SetupSequenceMatcher()
+{
+    auto& sequences = mSettings->mWordSequences;
+    mSequenceMatcher.Build( sequences );
+
+    mSequenceNames.clear();
+    for( auto& sequence : sequences )
+    {
+        std::string name;
+        for( U16 word : sequence )
+        {
+            char number_str[ 16 ];
+            snprintf( number_str, sizeof( number_str ), "%s0x%X", name.empty() ? "" : " ", word );
+            name += number_str;
+        }
+        mSequenceNames.push_back( name );
+    }
+
+    mRecentFrameStarts.assign( std::max<U32>( mSequenceMatcher.GetMaxSequenceLength(), 1 ), 0 );
+    mFrameCount = 0;
+}
+
+void SimpleParallelAnalyzer::AddSequenceMatches( U16 value, U64 starting_sample, U64 ending_sample )
+{
+    U64 history_size = mRecentFrameStarts.size();
+    mRecentFrameStarts[ mFrameCount % history_size ] = starting_sample;
+
+    for( U32 sequence : mSequenceMatcher.Advance( value ) )
+    {
+        // the match spans from the start of the frame holding the first word to the end of this frame.
+        U32 length = mSequenceMatcher.GetSequenceLength( sequence );
+        U64 match_start = mRecentFrameStarts[ ( mFrameCount + 1 - length ) % history_size ];
+
+        FrameV2 match;
+        match.AddInteger( "sequence", sequence );
+        match.AddString( "words", mSequenceNames[ sequence ].c_str() );
+        mResults->AddFrameV2( match, "match", match_start, ending_sample );
+    }
+
+    mFrameCount++;
+}
+
+void SimpleParallelAnalyzer::SetupChecksum()
+{
+    // the bus is as wide as the highest data line in use, and words of up to 8 bits are checksummed as single bytes.
+    U32 bus_width = 0;
+    U32 count = mSettings->mDataChannels.size();
+    for( U32 i = 0; i < count; i++ )
+    {
+        if( mSettings->mDataChannels[ i ] != UNDEFINED_CHANNEL )
+            bus_width = i + 1;
+    }
+    U32 bytes_per_word = bus_width > 8 ? 2 : 1;
+
+    U64 idle_gap_samples = ( static_cast<U64>( mSettings->mChecksumIdleGapNs ) * mSampleRateHz ) / 1000000000ull;
+    if( mSettings->mChecksumIdleGapNs > 0 && idle_gap_samples == 0 )
+        idle_gap_samples = 1;
+
+    mChecksum.Setup( mSettings->mChecksumType, bytes_per_word, mSettings->mChecksumStartWord, idle_gap_samples );
+}
+
+void SimpleParallelAnalyzer::AddChecksumResult( U16 value, U64 starting_sample, U64 ending_sample )
+{
+    SimpleParallelChecksum::RunResult run;
+    if( mChecksum.AddWord( value, starting_sample, ending_sample, run ) )
+        AddChecksumFrame( run );
+}
+
+void SimpleParallelAnalyzer::CloseIdleChecksumRun()
+{
+    // a run normally closes when the next word arrives. When the clock stops, that could take until the end of the capture, so as soon as
+    // the idle gap passes without any clock transition, close the run. Note that WouldAdvancingCauseTransition blocks until enough data is
+    // available to answer. This is only called once every decoded word has been added.
+    U64 deadline;
+    if( !mChecksum.GetIdleDeadline( deadline ) || mClock->DoMoreTransitionsExistInCurrentData() )
+        return;
+
+    U64 sample = mClock->GetSampleNumber();
+    if( deadline > sample && mClock->WouldAdvancingCauseTransition( static_cast<U32>( std::min<U64>( deadline - sample, 0xFFFFFFFF ) ) ) )
+        return;
+
+    SimpleParallelChecksum::RunResult run;
+    if( mChecksum.CloseRun( run ) )
+    {
+        AddChecksumFrame( run );
+        mResults->CommitResults();
+    }
+}
+
+void SimpleParallelAnalyzer::AddChecksumFrame( const SimpleParallelChecksum::RunResult& run )
+{
+    FrameV2 checksum;
+    checksum.AddInteger( "computed", run.mComputed );
+    checksum.AddInteger( "expected", run.mExpected );
+    checksum.AddBoolean( "valid", run.mComputed == run.mExpected );
+    checksum.AddInteger( "words", run.mNumWords );
+    mResults->AddFrameV2( checksum, "checksum", run.mStartingSample, run.mEndingSample );
+}
+
 uint64_t SimpleParallelAnalyzer::AddFrame( uint16_t value, uint64_t starting_sample, uint64_t ending_sample )
 {
     assert( starting_sample <= ending_sample );
     FrameV2 frame_v2;
     frame_v2.AddInteger( "data", value );
+    for( auto& group : mChannelGroupFields )
+    {
+        frame_v2.AddInteger( group.mName.c_str(), group.Extract( value ) );
+    }
+    if( mMinimumClockPulseSamples > 1 )
+    {
+        frame_v2.AddInteger( "glitches", mGlitchCount );
+    }
 
     Frame frame;
     frame.mData1 = value;
@@ -310,8 +698,15 @@ uint64_t SimpleParallelAnalyzer::AddFrame( uint16_t value, uint64_t starting_sam
     frame.mStartingSampleInclusive = starting_sample;
     frame.mEndingSampleInclusive = ending_sample;
     mResults->AddFrame( frame );
+    mResults->AddPackedFrame( starting_sample, value );
     mResults->AddFrameV2( frame_v2, "data", frame.mStartingSampleInclusive, frame.mEndingSampleInclusive );
+    if( !mSequenceMatcher.IsEmpty() )
+        AddSequenceMatches( value, starting_sample, ending_sample );
+    if( mChecksum.IsEnabled() )
+        AddChecksumResult( value, starting_sample, ending_sample );
     mResults->CommitResults();
+    if( mFrameStream )
+        mFrameStream->Push( starting_sample, ending_sample, value );
     mLastFrameWidth = std::max<uint64_t>( ending_sample - starting_sample, 1 );
     return ending_sample;
 }
@@ -2,8 +2,14 @@
 #define SIMPLEPARALLEL_ANALYZER_H
 
 #include <Analyzer.h>
+#include <string>
+#include <vector>
 #include "SimpleParallelAnalyzerResults.h"
 #include "SimpleParallelSimulationDataGenerator.h"
+#include "SimpleParallelFrameStream.h"
+#include "SimpleParallelSequenceMatcher.h"
+#include "SimpleParallelChecksum.h"
+#include "SimpleParallelEdgeCache.h"
 
 class SimpleParallelAnalyzerSettings;
 class SimpleParallelAnalyzer : public Analyzer2
@@ -25,17 +31,72 @@ class SimpleParallelAnalyzer : public Analyzer2
 #pragma warning(                                                                                                                           \
     disable : 4251 ) // warning C4251: 'SerialAnalyzer::<...>' : class <...> needs to have dll-interface to be used by clients of class
 
+    // extracts one channel group from a data word. Each run moves a contiguous block of bits into place.
+    struct ChannelGroupField
+    {
+        struct BitRun
+        {
+            U8 mSourceShift;
+            U8 mDestinationShift;
+            U16 mMask;
+        };
+        std::string mName;
+        std::vector<BitRun> mRuns;
+
+        U16 Extract( U16 word ) const;
+    };
+
+    void SetupChannelGroupFields();
+    void SetupSequenceMatcher();
+    void AddSequenceMatches( U16 value, U64 starting_sample, U64 ending_sample );
+    void SetupChecksum();
+    void AddChecksumResult( U16 value, U64 starting_sample, U64 ending_sample );
+    void CloseIdleChecksumRun();
+    void AddChecksumFrame( const SimpleParallelChecksum::RunResult& run );
+    void SetupEdgeCache();
+    bool EdgeCacheMatchesCapture();
+    void StopEdgeCacheReplay( bool reached_end );
+    bool ReadEdgeCacheWord( U64 sample_number, U16& word );
     void DecodeBothEdges();
+    void AddFrameAndAdvanceToActiveEdge( Frame& frame );
+    void AdvanceClockToNextEdge();
+    bool TryAdvanceClockToNextEdge();
+    void AdvanceClockToNextRawEdge();
     uint16_t GetWordAtLocation( uint64_t sample_number );
     uint64_t AddFrame( uint16_t value, uint64_t starting_sample, uint64_t ending_sample );
     int64_t mLastFrameWidth = -1; // holds the width of the last frame, in samples, or -1 if no previous frames created.
+    U32 mMinimumClockPulseSamples = 0; // clock pulses narrower than this are filtered out as glitches. 0 or 1 disables the filter.
+    U64 mGlitchCount = 0;              // number of clock glitches filtered out in the current run.
+    U64 mLastGlitchSample = 0;         // starting sample of the most recent clock glitch.
 
     std::unique_ptr<SimpleParallelAnalyzerSettings> mSettings;
     std::unique_ptr<SimpleParallelAnalyzerResults> mResults;
+    std::unique_ptr<SimpleParallelFrameStream> mFrameStream;
+    U64 mRunNumber = 0; // counts WorkerThread runs, so frame stream consumers can tell a re-run from a new capture position.
 
     std::vector<AnalyzerChannelData*> mData;
     std::vector<U16> mDataMasks;
     std::vector<Channel> mDataChannels;
+    std::vector<ChannelGroupField> mChannelGroupFields;
+
+    SimpleParallelSequenceMatcher mSequenceMatcher;
+    std::vector<std::string> mSequenceNames;
+    std::vector<U64> mRecentFrameStarts; // starting samples of the most recent frames, indexed by frame count modulo the size.
+    U64 mFrameCount = 0;
+
+    SimpleParallelChecksum mChecksum;
+
+    // clock transitions and line states of the previous runs, kept across runs so a settings change can rebuild frames without walking
+    // the channels again.
+    SimpleParallelEdgeCache mEdgeCache;
+    std::vector<AnalyzerChannelData*> mEdgeCacheLineData; // channel data for each cache line while recording, empty otherwise.
+    U32 mEdgeCacheSettingsRevision = 0;
+    U32 mEdgeCacheSettingsLoadCount = 0;
+    bool mEdgeCacheReplaying = false;                 // true while the clock is still within the cache, and agrees with it.
+    SimpleParallelEdgeCache::Cursor mEdgeCacheCursor; // the cached transition at the clock's current position, while replaying.
+    U16 mEdgeCacheWordTables[ 2 ][ 256 ];             // data word for each byte of cached line state, low byte first.
+    U64 mEdgeCacheWordsRead = 0;                      // words taken from the cache this run.
+    static const U64 EdgeCacheSpotCheckInterval = 64; // read the data lines for every this many words taken from the cache.
     AnalyzerChannelData* mClock;
 
     SimpleParallelSimulationDataGenerator mSimulationDataGenerator;
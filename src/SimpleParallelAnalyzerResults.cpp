@@ -3,11 +3,20 @@
 #include "SimpleParallelAnalyzer.h"
 #include "SimpleParallelAnalyzerSettings.h"
 #include <iostream>
-#include <sstream>
 #include <stdio.h>
+#include <algorithm>
+
+namespace
+{
+    const U32 PackedSampleShift = 16;
+    const U64 MaxPackedSample = ( 1ull << ( 64 - PackedSampleShift ) ) - 1;
+    const U64 ExportChunkFrames = 4096;
+    const size_t ExportChunkBytes = 1 << 20;
+    const size_t MaxFormattedExportBytes = 256 << 20;
+}
 
 SimpleParallelAnalyzerResults::SimpleParallelAnalyzerResults( SimpleParallelAnalyzer* analyzer, SimpleParallelAnalyzerSettings* settings )
-    : AnalyzerResults(), mSettings( settings ), mAnalyzer( analyzer )
+    : AnalyzerResults(), mSettings( settings ), mAnalyzer( analyzer ), mPackedFramesValid( true ), mNumExports( 0 )
 {
 }
 
@@ -25,31 +34,163 @@ void SimpleParallelAnalyzerResults::GenerateBubbleText( U64 frame_index, Channel
     AddResultString( number_str );
 }
 
+void SimpleParallelAnalyzerResults::AddPackedFrame( U64 starting_sample, U16 value )
+{
+    std::lock_guard<std::mutex> lock( mPackedFramesMutex );
+    if( starting_sample > MaxPackedSample )
+    {
+        mPackedFramesValid = false;
+        return;
+    }
+    mPackedFrames.push_back( ( starting_sample << PackedSampleShift ) | value );
+}
+
+void SimpleParallelAnalyzerResults::FormatExportLine( std::string& text, U64 starting_sample, U16 value, U64 trigger_sample,
+                                                      U32 sample_rate, DisplayBase display_base )
+{
+    char time_str[ 128 ];
+    AnalyzerHelpers::GetTimeString( starting_sample, trigger_sample, sample_rate, time_str, 128 );
+
+    char number_str[ 128 ];
+    AnalyzerHelpers::GetNumberString( value, display_base, 16, number_str, 128 );
+
+    text += time_str;
+    text += ',';
+    text += number_str;
+    text += '\n';
+}
+
 void SimpleParallelAnalyzerResults::GenerateExportFile( const char* file, DisplayBase display_base, U32 export_type_user_id )
 {
-    std::stringstream ss;
     void* f = AnalyzerHelpers::StartFile( file );
 
+    std::string header = "Time [s],Value\n";
+    AnalyzerHelpers::AppendToFile( ( U8* )header.c_str(), header.length(), f );
+
+    bool packed_frames_valid;
+    {
+        std::lock_guard<std::mutex> lock( mPackedFramesMutex );
+        packed_frames_valid = mPackedFramesValid;
+    }
+    if( !packed_frames_valid )
+    {
+        GenerateExportFileFromFrames( f, display_base );
+        return;
+    }
+
     U64 trigger_sample = mAnalyzer->GetTriggerSample();
     U32 sample_rate = mAnalyzer->GetSampleRate();
 
-    ss << "Time [s],Value" << std::endl;
+    std::lock_guard<std::mutex> export_lock( mFormattedExportsMutex );
+    FormattedExport& cache = mFormattedExports[ display_base ];
+    if( cache.mTriggerSample != trigger_sample || cache.mSampleRate != sample_rate )
+    {
+        // release the memory of the stale text, rather than just its contents.
+        std::string().swap( cache.mText );
+        cache.mNumFrames = 0;
+    }
+    cache.mTriggerSample = trigger_sample;
+    cache.mSampleRate = sample_rate;
+    cache.mLastExport = ++mNumExports;
 
-    U64 num_frames = GetNumFrames();
-    for( U32 i = 0; i < num_frames; i++ )
+    U64 num_frames;
     {
-        Frame frame = GetFrame( i );
+        std::lock_guard<std::mutex> lock( mPackedFramesMutex );
+        num_frames = std::min<U64>( GetNumFrames(), mPackedFrames.size() );
+    }
+
+    // stream the lines formatted by previous exports.
+    for( size_t offset = 0; offset < cache.mText.size(); offset += ExportChunkBytes )
+    {
+        size_t length = std::min( ExportChunkBytes, cache.mText.size() - offset );
+        AnalyzerHelpers::AppendToFile( ( U8* )cache.mText.data() + offset, length, f );
+
+        if( UpdateExportProgressAndCheckForCancel( cache.mNumFrames * offset / cache.mText.size(), num_frames ) == true )
+        {
+            AnalyzerHelpers::EndFile( f );
+            return;
+        }
+    }
 
-        char time_str[ 128 ];
-        AnalyzerHelpers::GetTimeString( frame.mStartingSampleInclusive, trigger_sample, sample_rate, time_str, 128 );
+    // format the remaining frames from the packed store. New lines are kept for the next export until the cache is full.
+    std::vector<U64> chunk;
+    std::string uncached_text;
+    U64 next_frame = cache.mNumFrames;
+    while( next_frame < num_frames )
+    {
+        U64 chunk_frames = std::min<U64>( num_frames - next_frame, ExportChunkFrames );
+        {
+            std::lock_guard<std::mutex> lock( mPackedFramesMutex );
+            chunk.assign( mPackedFrames.begin() + next_frame, mPackedFrames.begin() + next_frame + chunk_frames );
+        }
 
-        char number_str[ 128 ];
-        AnalyzerHelpers::GetNumberString( frame.mData1, display_base, 16, number_str, 128 );
+        bool keep = cache.mNumFrames == next_frame && ReserveFormattedExportSpace( display_base );
+        std::string& text = keep ? cache.mText : uncached_text;
+        if( !keep )
+            uncached_text.clear();
+
+        size_t chunk_offset = text.size();
+        for( U64 packed : chunk )
+        {
+            FormatExportLine( text, packed >> PackedSampleShift, static_cast<U16>( packed ), trigger_sample, sample_rate, display_base );
+        }
+        next_frame += chunk_frames;
+        if( keep )
+            cache.mNumFrames = next_frame;
+
+        AnalyzerHelpers::AppendToFile( ( U8* )text.data() + chunk_offset, text.size() - chunk_offset, f );
+
+        if( UpdateExportProgressAndCheckForCancel( next_frame, num_frames ) == true )
+        {
+            AnalyzerHelpers::EndFile( f );
+            return;
+        }
+    }
+
+    UpdateExportProgressAndCheckForCancel( num_frames, num_frames );
+    AnalyzerHelpers::EndFile( f );
+}
 
-        ss << time_str << "," << number_str << std::endl;
+bool SimpleParallelAnalyzerResults::ReserveFormattedExportSpace( DisplayBase display_base )
+{
+    for( ;; )
+    {
+        size_t total_bytes = 0;
+        FormattedExport* least_recent = nullptr;
+        for( auto& entry : mFormattedExports )
+        {
+            FormattedExport& formatted = entry.second;
+            total_bytes += formatted.mText.size();
+            if( entry.first != display_base && !formatted.mText.empty() &&
+                ( least_recent == nullptr || formatted.mLastExport < least_recent->mLastExport ) )
+                least_recent = &formatted;
+        }
+
+        if( total_bytes < MaxFormattedExportBytes )
+            return true;
+        if( least_recent == nullptr )
+            return false;
+
+        std::string().swap( least_recent->mText );
+        least_recent->mNumFrames = 0;
+    }
+}
+
+void SimpleParallelAnalyzerResults::GenerateExportFileFromFrames( void* f, DisplayBase display_base )
+{
+    U64 trigger_sample = mAnalyzer->GetTriggerSample();
+    U32 sample_rate = mAnalyzer->GetSampleRate();
+
+    std::string text;
+    U64 num_frames = GetNumFrames();
+    for( U64 i = 0; i < num_frames; i++ )
+    {
+        Frame frame = GetFrame( i );
+        FormatExportLine( text, frame.mStartingSampleInclusive, static_cast<U16>( frame.mData1 ), trigger_sample, sample_rate,
+                          display_base );
 
-        AnalyzerHelpers::AppendToFile( ( U8* )ss.str().c_str(), ss.str().length(), f );
-        ss.str( std::string() );
+        AnalyzerHelpers::AppendToFile( ( U8* )text.c_str(), text.length(), f );
+        text.clear();
 
         if( UpdateExportProgressAndCheckForCancel( i, num_frames ) == true )
         {
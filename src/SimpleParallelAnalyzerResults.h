@@ -2,6 +2,10 @@
 #define SIMPLEPARALLEL_ANALYZER_RESULTS
 
 #include <AnalyzerResults.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
 
 class SimpleParallelAnalyzer;
 class SimpleParallelAnalyzerSettings;
@@ -19,10 +23,40 @@ class SimpleParallelAnalyzerResults : public AnalyzerResults
     virtual void GeneratePacketTabularText( U64 packet_id, DisplayBase display_base );
     virtual void GenerateTransactionTabularText( U64 transaction_id, DisplayBase display_base );
 
+    // records a frame in the packed export store. Called by the analyzer for every frame it adds, in order.
+    void AddPackedFrame( U64 starting_sample, U16 value );
+
   protected: // functions
+    void GenerateExportFileFromFrames( void* f, DisplayBase display_base );
+    void FormatExportLine( std::string& text, U64 starting_sample, U16 value, U64 trigger_sample, U32 sample_rate,
+                           DisplayBase display_base );
+
   protected: // vars
     SimpleParallelAnalyzerSettings* mSettings;
     SimpleParallelAnalyzer* mAnalyzer;
+
+    // every frame's starting sample and word, packed as ( starting_sample << 16 ) | word. Appended by the worker thread while exports
+    // read it, so it is guarded by mPackedFramesMutex.
+    std::mutex mPackedFramesMutex;
+    std::vector<U64> mPackedFrames;
+    bool mPackedFramesValid; // false once a starting sample does not fit in 48 bits.
+
+    // already formatted export lines, per display base. Frames are only ever appended, so repeat exports reuse the cached lines and only
+    // format frames decoded since. All bases share MaxFormattedExportBytes of text: when it runs out, the least recently exported base is
+    // dropped, and if only the base being exported is left, its later lines are formatted from the packed store on every export.
+    struct FormattedExport
+    {
+        U64 mTriggerSample = 0;
+        U32 mSampleRate = 0;
+        U64 mNumFrames = 0;
+        U64 mLastExport = 0;
+        std::string mText;
+    };
+    bool ReserveFormattedExportSpace( DisplayBase display_base );
+
+    std::mutex mFormattedExportsMutex;
+    std::map<DisplayBase, FormattedExport> mFormattedExports;
+    U64 mNumExports;
 };
 
 #endif // SIMPLEPARALLEL_ANALYZER_RESULTS
@@ -1,12 +1,217 @@
 #include "SimpleParallelAnalyzerSettings.h"
 #include <AnalyzerHelpers.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <errno.h>
 
 
 #pragma warning( disable : 4996 ) // warning C4996: 'sprintf': This function or variable may be unsafe
 
+static std::string TrimWhitespace( const std::string& text )
+{
+    size_t first = text.find_first_not_of( " \t\r\n" );
+    if( first == std::string::npos )
+        return std::string();
+    size_t last = text.find_last_not_of( " \t\r\n" );
+    return text.substr( first, last - first + 1 );
+}
+
+// parses a single data line reference, "D5" or "5". Returns -1 if the text is not a line reference.
+static int ParseDataLineIndex( const std::string& text )
+{
+    std::string digits = TrimWhitespace( text );
+    if( !digits.empty() && ( digits[ 0 ] == 'D' || digits[ 0 ] == 'd' ) )
+        digits = digits.substr( 1 );
+    if( digits.empty() || !isdigit( static_cast<unsigned char>( digits[ 0 ] ) ) )
+        return -1;
+
+    // range check before narrowing, so a huge index like D4294967296 can't wrap around to a valid line.
+    char* end = nullptr;
+    errno = 0;
+    long index = strtol( digits.c_str(), &end, 10 );
+    if( *end != '\0' || errno == ERANGE || index > 15 )
+        return -1;
+    return static_cast<int>( index );
+}
+
+// parses the channel groups setting, for example "addr=D0-D7; data=D8-D15; ctrl=D12,D14".
+// Groups are separated by ';', and each group lists single lines or inclusive line ranges separated by ','.
+static bool ParseChannelGroups( const std::string& text, const std::vector<Channel>& data_channels,
+                                std::vector<ParallelChannelGroup>& groups, std::string& error )
+{
+    groups.clear();
+
+    size_t group_start = 0;
+    while( group_start <= text.size() )
+    {
+        size_t group_end = text.find( ';', group_start );
+        if( group_end == std::string::npos )
+            group_end = text.size();
+        std::string group_text = TrimWhitespace( text.substr( group_start, group_end - group_start ) );
+        group_start = group_end + 1;
+
+        if( group_text.empty() )
+            continue;
+
+        size_t equals = group_text.find( '=' );
+        if( equals == std::string::npos )
+        {
+            error = "Channel group \"" + group_text + "\" must be written as name=D0-D7";
+            return false;
+        }
+
+        ParallelChannelGroup group;
+        group.mName = TrimWhitespace( group_text.substr( 0, equals ) );
+        group.mMask = 0;
+
+        bool valid_name = !group.mName.empty() && !isdigit( static_cast<unsigned char>( group.mName[ 0 ] ) );
+        for( char c : group.mName )
+        {
+            if( !isalnum( static_cast<unsigned char>( c ) ) && c != '_' )
+                valid_name = false;
+        }
+        if( !valid_name )
+        {
+            error = "Channel group name \"" + group.mName + "\" must start with a letter and only contain letters, digits and underscores";
+            return false;
+        }
+        for( auto& existing : groups )
+        {
+            if( existing.mName == group.mName )
+            {
+                error = "Channel group \"" + group.mName + "\" is defined more than once";
+                return false;
+            }
+        }
+
+        std::string members = group_text.substr( equals + 1 );
+        size_t member_start = 0;
+        while( member_start <= members.size() )
+        {
+            size_t member_end = members.find( ',', member_start );
+            if( member_end == std::string::npos )
+                member_end = members.size();
+            std::string member = TrimWhitespace( members.substr( member_start, member_end - member_start ) );
+            member_start = member_end + 1;
+
+            if( member.empty() )
+                continue;
+
+            int first_line;
+            int last_line;
+            size_t dash = member.find( '-' );
+            if( dash == std::string::npos )
+            {
+                first_line = last_line = ParseDataLineIndex( member );
+            }
+            else
+            {
+                first_line = ParseDataLineIndex( member.substr( 0, dash ) );
+                last_line = ParseDataLineIndex( member.substr( dash + 1 ) );
+            }
+
+            if( first_line < 0 || last_line < first_line || last_line >= static_cast<int>( data_channels.size() ) )
+            {
+                error = "Channel group \"" + group.mName + "\" has an invalid line \"" + member + "\"";
+                return false;
+            }
+
+            for( int i = first_line; i <= last_line; i++ )
+            {
+                if( data_channels[ i ] == UNDEFINED_CHANNEL )
+                {
+                    error = "Channel group \"" + group.mName + "\" uses D" + std::to_string( i ) + ", which has no channel selected";
+                    return false;
+                }
+                group.mMask |= 1 << i;
+            }
+        }
+
+        if( group.mMask == 0 )
+        {
+            error = "Channel group \"" + group.mName + "\" does not contain any data lines";
+            return false;
+        }
+
+        groups.push_back( group );
+    }
+
+    return true;
+}
+
+// parses the word sequences setting, for example "0xA5 0x01; 0xA5 0x02 0x03".
+// Sequences are separated by ';', and words are separated by spaces or ','. Words may be decimal, hex (0x) or octal (leading 0).
+static bool ParseWordSequences( const std::string& text, std::vector<std::vector<U16>>& sequences, std::string& error )
+{
+    sequences.clear();
+
+    size_t sequence_start = 0;
+    while( sequence_start <= text.size() )
+    {
+        size_t sequence_end = text.find( ';', sequence_start );
+        if( sequence_end == std::string::npos )
+            sequence_end = text.size();
+        std::string sequence_text = text.substr( sequence_start, sequence_end - sequence_start );
+        sequence_start = sequence_end + 1;
+
+        std::vector<U16> sequence;
+        size_t word_start = sequence_text.find_first_not_of( " \t\r\n," );
+        while( word_start != std::string::npos )
+        {
+            size_t word_end = sequence_text.find_first_of( " \t\r\n,", word_start );
+            if( word_end == std::string::npos )
+                word_end = sequence_text.size();
+            std::string word = sequence_text.substr( word_start, word_end - word_start );
+            word_start = sequence_text.find_first_not_of( " \t\r\n,", word_end );
+
+            char* end = nullptr;
+            unsigned long value = strtoul( word.c_str(), &end, 0 );
+            if( *end != '\0' || !isdigit( static_cast<unsigned char>( word[ 0 ] ) ) || value > 0xFFFF )
+            {
+                error = "Word sequence value \"" + word + "\" is not a 16 bit number";
+                return false;
+            }
+            sequence.push_back( static_cast<U16>( value ) );
+        }
+
+        if( !sequence.empty() )
+            sequences.push_back( sequence );
+    }
+
+    return true;
+}
+
+// parses the checksum start word setting. An empty setting means runs are not delimited by a start word.
+static bool ParseChecksumStartWord( const std::string& text, S64& start_word, std::string& error )
+{
+    std::string word = TrimWhitespace( text );
+    if( word.empty() )
+    {
+        start_word = -1;
+        return true;
+    }
+
+    char* end = nullptr;
+    unsigned long value = strtoul( word.c_str(), &end, 0 );
+    if( *end != '\0' || !isdigit( static_cast<unsigned char>( word[ 0 ] ) ) || value > 0xFFFF )
+    {
+        error = "Checksum start word \"" + word + "\" is not a 16 bit number";
+        return false;
+    }
+    start_word = value;
+    return true;
+}
+
 SimpleParallelAnalyzerSettings::SimpleParallelAnalyzerSettings()
-    : mClockChannel( UNDEFINED_CHANNEL ), mClockEdge( ParallelAnalyzerClockEdge::PosEdge )
+    : mClockChannel( UNDEFINED_CHANNEL ),
+      mClockEdge( ParallelAnalyzerClockEdge::PosEdge ),
+      mMinimumClockPulseNs( 0 ),
+      mChecksumType( ParallelChecksumType::None ),
+      mChecksumStartWord( -1 ),
+      mChecksumIdleGapNs( 0 ),
+      mRevision( 0 ),
+      mLoadCount( 0 )
 {
     U32 count = 16;
     for( U32 i = 0; i < count; i++ )
@@ -36,6 +241,53 @@ SimpleParallelAnalyzerSettings::SimpleParallelAnalyzerSettings()
     mClockEdgeInterface->AddNumber( static_cast<double>( ParallelAnalyzerClockEdge::DualEdge ), "Dual edge", "" );
     mClockEdgeInterface->SetNumber( static_cast<double>( mClockEdge ) );
 
+    mMinimumClockPulseInterface.reset( new AnalyzerSettingInterfaceInteger() );
+    mMinimumClockPulseInterface->SetTitleAndTooltip(
+        "Minimum clock pulse width (ns)", "Clock high or low pulses narrower than this are ignored as glitches. 0 disables the filter." );
+    mMinimumClockPulseInterface->SetMin( 0 );
+    mMinimumClockPulseInterface->SetMax( 1000000000 );
+    mMinimumClockPulseInterface->SetInteger( mMinimumClockPulseNs );
+
+    mChannelGroupsInterface.reset( new AnalyzerSettingInterfaceText() );
+    mChannelGroupsInterface->SetTitleAndTooltip( "Channel groups",
+                                                 "Optional named groups of data lines, each decoded as a separate group.<name> field "
+                                                 "of every frame. Example: addr=D0-D7; data=D8-D15; ctrl=D12,D14" );
+    mChannelGroupsInterface->SetText( mChannelGroupsText.c_str() );
+
+    mFrameStreamPathInterface.reset( new AnalyzerSettingInterfaceText() );
+    mFrameStreamPathInterface->SetTitleAndTooltip( "Frame stream socket",
+                                                   "Optional. Path of a Unix domain socket (or \\\\.\\pipe\\name on Windows) to stream "
+                                                   "decoded frames to while decoding. Leave empty to disable." );
+    mFrameStreamPathInterface->SetText( mFrameStreamPath.c_str() );
+
+    mWordSequencesInterface.reset( new AnalyzerSettingInterfaceText() );
+    mWordSequencesInterface->SetTitleAndTooltip( "Word sequences",
+                                                 "Optional word sequences to search for while decoding. Each occurrence is added as a "
+                                                 "match frame. Example: 0xA5 0x01; 0xA5 0x02 0x03" );
+    mWordSequencesInterface->SetText( mWordSequencesText.c_str() );
+
+    mChecksumTypeInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mChecksumTypeInterface->SetTitleAndTooltip( "Checksum", "Verify a checksum carried in the last words of each run of words" );
+    mChecksumTypeInterface->AddNumber( static_cast<double>( ParallelChecksumType::None ), "None", "" );
+    mChecksumTypeInterface->AddNumber( static_cast<double>( ParallelChecksumType::Sum8 ), "8-bit sum of bytes", "" );
+    mChecksumTypeInterface->AddNumber( static_cast<double>( ParallelChecksumType::Sum16 ), "16-bit sum of words", "" );
+    mChecksumTypeInterface->AddNumber( static_cast<double>( ParallelChecksumType::Crc16CcittFalse ), "CRC-16/CCITT-FALSE", "" );
+    mChecksumTypeInterface->AddNumber( static_cast<double>( ParallelChecksumType::Crc32 ), "CRC-32", "" );
+    mChecksumTypeInterface->SetNumber( static_cast<double>( mChecksumType ) );
+
+    mChecksumStartWordInterface.reset( new AnalyzerSettingInterfaceText() );
+    mChecksumStartWordInterface->SetTitleAndTooltip( "Checksum run start word",
+                                                     "Optional. A word that starts every checksummed run, for example 0x7E. "
+                                                     "Leave empty to delimit runs by idle gaps only." );
+    mChecksumStartWordInterface->SetText( "" );
+
+    mChecksumIdleGapInterface.reset( new AnalyzerSettingInterfaceInteger() );
+    mChecksumIdleGapInterface->SetTitleAndTooltip( "Checksum run idle gap (ns)",
+                                                   "A run ends when no active clock edge is seen for longer than this. 0 disables." );
+    mChecksumIdleGapInterface->SetMin( 0 );
+    mChecksumIdleGapInterface->SetMax( 1000000000 );
+    mChecksumIdleGapInterface->SetInteger( mChecksumIdleGapNs );
+
 
     for( U32 i = 0; i < count; i++ )
     {
@@ -44,6 +296,13 @@ SimpleParallelAnalyzerSettings::SimpleParallelAnalyzerSettings()
 
     AddInterface( mClockChannelInterface.get() );
     AddInterface( mClockEdgeInterface.get() );
+    AddInterface( mMinimumClockPulseInterface.get() );
+    AddInterface( mChannelGroupsInterface.get() );
+    AddInterface( mFrameStreamPathInterface.get() );
+    AddInterface( mWordSequencesInterface.get() );
+    AddInterface( mChecksumTypeInterface.get() );
+    AddInterface( mChecksumStartWordInterface.get() );
+    AddInterface( mChecksumIdleGapInterface.get() );
 
     AddExportOption( 0, "Export as text/csv file" );
     AddExportExtension( 0, "text", "txt" );
@@ -83,13 +342,57 @@ bool SimpleParallelAnalyzerSettings::SetSettingsFromInterfaces()
         return false;
     }
 
+    std::vector<Channel> data_channels;
     for( U32 i = 0; i < count; i++ )
     {
-        mDataChannels[ i ] = mDataChannelsInterface[ i ]->GetChannel();
+        data_channels.push_back( mDataChannelsInterface[ i ]->GetChannel() );
+    }
+
+    std::string channel_groups_text = mChannelGroupsInterface->GetText();
+    std::vector<ParallelChannelGroup> channel_groups;
+    std::string error;
+    if( !ParseChannelGroups( channel_groups_text, data_channels, channel_groups, error ) )
+    {
+        SetErrorText( error.c_str() );
+        return false;
+    }
+
+    std::string word_sequences_text = mWordSequencesInterface->GetText();
+    std::vector<std::vector<U16>> word_sequences;
+    if( !ParseWordSequences( word_sequences_text, word_sequences, error ) )
+    {
+        SetErrorText( error.c_str() );
+        return false;
+    }
+
+    ParallelChecksumType checksum_type = static_cast<ParallelChecksumType>( U32( mChecksumTypeInterface->GetNumber() ) );
+    S64 checksum_start_word;
+    if( !ParseChecksumStartWord( mChecksumStartWordInterface->GetText(), checksum_start_word, error ) )
+    {
+        SetErrorText( error.c_str() );
+        return false;
     }
+    U32 checksum_idle_gap_ns = mChecksumIdleGapInterface->GetInteger();
+    if( checksum_type != ParallelChecksumType::None && checksum_start_word < 0 && checksum_idle_gap_ns == 0 )
+    {
+        SetErrorText( "Please set a checksum run start word, an idle gap, or both" );
+        return false;
+    }
+
+    mDataChannels = data_channels;
+    mChannelGroupsText = channel_groups_text;
+    mChannelGroups = channel_groups;
+    mFrameStreamPath = mFrameStreamPathInterface->GetText();
+    mWordSequencesText = word_sequences_text;
+    mWordSequences = word_sequences;
+    mChecksumType = checksum_type;
+    mChecksumStartWord = checksum_start_word;
+    mChecksumIdleGapNs = checksum_idle_gap_ns;
+    mRevision++;
 
     mClockChannel = mClockChannelInterface->GetChannel();
     mClockEdge = static_cast<ParallelAnalyzerClockEdge>( U32( mClockEdgeInterface->GetNumber() ) );
+    mMinimumClockPulseNs = mMinimumClockPulseInterface->GetInteger();
 
     ClearChannels();
     for( U32 i = 0; i < count; i++ )
@@ -114,6 +417,22 @@ void SimpleParallelAnalyzerSettings::UpdateInterfacesFromSettings()
 
     mClockChannelInterface->SetChannel( mClockChannel );
     mClockEdgeInterface->SetNumber( static_cast<double>( mClockEdge ) );
+    mMinimumClockPulseInterface->SetInteger( mMinimumClockPulseNs );
+    mChannelGroupsInterface->SetText( mChannelGroupsText.c_str() );
+    mFrameStreamPathInterface->SetText( mFrameStreamPath.c_str() );
+    mWordSequencesInterface->SetText( mWordSequencesText.c_str() );
+    mChecksumTypeInterface->SetNumber( static_cast<double>( mChecksumType ) );
+    if( mChecksumStartWord >= 0 )
+    {
+        char text[ 16 ];
+        sprintf( text, "0x%X", static_cast<U32>( mChecksumStartWord ) );
+        mChecksumStartWordInterface->SetText( text );
+    }
+    else
+    {
+        mChecksumStartWordInterface->SetText( "" );
+    }
+    mChecksumIdleGapInterface->SetInteger( mChecksumIdleGapNs );
 }
 
 void SimpleParallelAnalyzerSettings::LoadSettings( const char* settings )
@@ -133,6 +452,44 @@ void SimpleParallelAnalyzerSettings::LoadSettings( const char* settings )
     text_archive >> edge;
     mClockEdge = static_cast<ParallelAnalyzerClockEdge>( edge );
 
+    // settings saved by older versions end here.
+    const char* channel_groups_text = "";
+    if( text_archive >> &channel_groups_text )
+        mChannelGroupsText = channel_groups_text;
+    else
+        mChannelGroupsText.clear();
+
+    if( !( text_archive >> mMinimumClockPulseNs ) )
+        mMinimumClockPulseNs = 0;
+
+    const char* frame_stream_path = "";
+    if( text_archive >> &frame_stream_path )
+        mFrameStreamPath = frame_stream_path;
+    else
+        mFrameStreamPath.clear();
+
+    const char* word_sequences_text = "";
+    if( text_archive >> &word_sequences_text )
+        mWordSequencesText = word_sequences_text;
+    else
+        mWordSequencesText.clear();
+
+    U32 checksum_type;
+    if( !( text_archive >> checksum_type ) || !( text_archive >> mChecksumStartWord ) || !( text_archive >> mChecksumIdleGapNs ) )
+    {
+        checksum_type = static_cast<U32>( ParallelChecksumType::None );
+        mChecksumStartWord = -1;
+        mChecksumIdleGapNs = 0;
+    }
+    mChecksumType = static_cast<ParallelChecksumType>( checksum_type );
+    mLoadCount++;
+
+    std::string error;
+    if( !ParseChannelGroups( mChannelGroupsText, mDataChannels, mChannelGroups, error ) )
+        mChannelGroups.clear();
+    if( !ParseWordSequences( mWordSequencesText, mWordSequences, error ) )
+        mWordSequences.clear();
+
     ClearChannels();
     for( U32 i = 0; i < count; i++ )
     {
@@ -160,6 +517,13 @@ const char* SimpleParallelAnalyzerSettings::SaveSettings()
     text_archive << mClockChannel;
     U32 edge = static_cast<U32>( mClockEdge );
     text_archive << edge;
+    text_archive << mChannelGroupsText.c_str();
+    text_archive << mMinimumClockPulseNs;
+    text_archive << mFrameStreamPath.c_str();
+    text_archive << mWordSequencesText.c_str();
+    text_archive << static_cast<U32>( mChecksumType );
+    text_archive << mChecksumStartWord;
+    text_archive << mChecksumIdleGapNs;
 
     return SetReturnString( text_archive.GetString() );
 }
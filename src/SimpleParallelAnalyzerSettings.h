@@ -3,6 +3,8 @@
 
 #include <AnalyzerSettings.h>
 #include <AnalyzerTypes.h>
+#include <string>
+#include <vector>
 
 // originally from AnalyzerEnums::EdgeDirection { PosEdge, NegEdge };
 enum class ParallelAnalyzerClockEdge
@@ -12,6 +14,23 @@ enum class ParallelAnalyzerClockEdge
     DualEdge
 };
 
+enum class ParallelChecksumType
+{
+    None,
+    Sum8,
+    Sum16,
+    Crc16CcittFalse,
+    Crc32
+};
+
+// a named subset of the data lines, decoded as its own FrameV2 field "group.<name>". Bit 0 of the field is the lowest numbered data line
+// in the group.
+struct ParallelChannelGroup
+{
+    std::string mName;
+    U16 mMask;
+};
+
 class SimpleParallelAnalyzerSettings : public AnalyzerSettings
 {
   public:
@@ -28,12 +47,36 @@ class SimpleParallelAnalyzerSettings : public AnalyzerSettings
     Channel mClockChannel;
 
     ParallelAnalyzerClockEdge mClockEdge;
+    U32 mMinimumClockPulseNs;
+
+    std::string mChannelGroupsText;
+    std::vector<ParallelChannelGroup> mChannelGroups;
+
+    std::string mFrameStreamPath;
+
+    std::string mWordSequencesText;
+    std::vector<std::vector<U16>> mWordSequences;
+
+    ParallelChecksumType mChecksumType;
+    S64 mChecksumStartWord; // -1 if runs are only delimited by idle gaps.
+    U32 mChecksumIdleGapNs; // 0 if runs are only delimited by the start word.
+
+    U32 mRevision;  // incremented whenever the settings are changed from the settings dialog.
+    U32 mLoadCount; // incremented whenever saved settings are loaded, which may come with a different capture.
 
   protected:
+
     std::vector<AnalyzerSettingInterfaceChannel*> mDataChannelsInterface;
 
     std::unique_ptr<AnalyzerSettingInterfaceChannel> mClockChannelInterface;
     std::unique_ptr<AnalyzerSettingInterfaceNumberList> mClockEdgeInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceInteger> mMinimumClockPulseInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceText> mChannelGroupsInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceText> mFrameStreamPathInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceText> mWordSequencesInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceNumberList> mChecksumTypeInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceText> mChecksumStartWordInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceInteger> mChecksumIdleGapInterface;
 };
 
 #endif // SIMPLEPARALLEL_ANALYZER_SETTINGS
@@ -0,0 +1,215 @@
+#include "SimpleParallelChecksum.h"
+#include <string.h>
+
+SimpleParallelChecksum::SimpleParallelChecksum()
+{
+    Setup( ParallelChecksumType::None, 1, -1, 0 );
+}
+
+void SimpleParallelChecksum::Setup( ParallelChecksumType type, U32 bytes_per_word, S64 start_word, U64 idle_gap_samples )
+{
+    mType = type;
+    mBytesPerWord = bytes_per_word;
+    mStartWord = start_word;
+    mIdleGapSamples = idle_gap_samples;
+    memset( mTables, 0, sizeof( mTables ) );
+
+    switch( mType )
+    {
+    case ParallelChecksumType::None:
+    case ParallelChecksumType::Sum8:
+        mChecksumBytes = 1;
+        mInitialValue = 0;
+        break;
+    case ParallelChecksumType::Sum16:
+        mChecksumBytes = 2;
+        mInitialValue = 0;
+        break;
+    case ParallelChecksumType::Crc16CcittFalse:
+        // poly 0x1021, MSB first. mTables[ 1 ] is the effect of a byte followed by one more zero byte.
+        mChecksumBytes = 2;
+        mInitialValue = 0xFFFF;
+        for( U32 i = 0; i < 256; i++ )
+        {
+            U32 crc = i << 8;
+            for( U32 bit = 0; bit < 8; bit++ )
+                crc = ( crc & 0x8000 ) ? ( ( crc << 1 ) ^ 0x1021 ) : ( crc << 1 );
+            mTables[ 0 ][ i ] = crc & 0xFFFF;
+        }
+        for( U32 i = 0; i < 256; i++ )
+            mTables[ 1 ][ i ] = ( ( mTables[ 0 ][ i ] << 8 ) & 0xFFFF ) ^ mTables[ 0 ][ mTables[ 0 ][ i ] >> 8 ];
+        break;
+    case ParallelChecksumType::Crc32:
+        // poly 0x04C11DB7, reflected, as used by Ethernet and zip.
+        mChecksumBytes = 4;
+        mInitialValue = 0xFFFFFFFF;
+        for( U32 i = 0; i < 256; i++ )
+        {
+            U32 crc = i;
+            for( U32 bit = 0; bit < 8; bit++ )
+                crc = ( crc & 1 ) ? ( ( crc >> 1 ) ^ 0xEDB88320 ) : ( crc >> 1 );
+            mTables[ 0 ][ i ] = crc;
+        }
+        for( U32 i = 0; i < 256; i++ )
+            mTables[ 1 ][ i ] = ( mTables[ 0 ][ i ] >> 8 ) ^ mTables[ 0 ][ mTables[ 0 ][ i ] & 0xFF ];
+        break;
+    }
+
+    mChecksumWords = ( mChecksumBytes + mBytesPerWord - 1 ) / mBytesPerWord;
+    mPendingWords.assign( mChecksumWords, 0 );
+    mPendingIndex = 0;
+
+    mRunActive = false;
+    mRunStartingSample = 0;
+    mRunEndingSample = 0;
+    mRunWords = 0;
+    mPreviousStartingSample = 0;
+    mHasPreviousWord = false;
+    mValue = mInitialValue;
+}
+
+bool SimpleParallelChecksum::IsEnabled() const
+{
+    return mType != ParallelChecksumType::None;
+}
+
+bool SimpleParallelChecksum::AddWord( U16 word, U64 starting_sample, U64 ending_sample, RunResult& result )
+{
+    bool finished = false;
+
+    // words are spaced by active clock edges, so a stopped clock shows up as a long gap between word starts.
+    bool gap_elapsed = mIdleGapSamples > 0 && mHasPreviousWord && starting_sample - mPreviousStartingSample > mIdleGapSamples;
+    if( gap_elapsed && mRunActive )
+    {
+        finished = FinishRun( result );
+        mRunActive = false;
+    }
+
+    bool starts_run;
+    if( mStartWord >= 0 )
+        starts_run = word == mStartWord;
+    else
+        starts_run = gap_elapsed || !mHasPreviousWord;
+
+    if( starts_run )
+    {
+        if( mRunActive )
+            finished = FinishRun( result );
+        StartRun( starting_sample );
+    }
+
+    mHasPreviousWord = true;
+    mPreviousStartingSample = starting_sample;
+
+    if( mRunActive )
+    {
+        // once the held back words are full, the oldest one is known to be payload.
+        if( mRunWords >= mChecksumWords )
+            Update( mPendingWords[ mPendingIndex ] );
+        mPendingWords[ mPendingIndex ] = word;
+        mPendingIndex = ( mPendingIndex + 1 ) % mChecksumWords;
+        mRunWords++;
+        mRunEndingSample = ending_sample;
+    }
+
+    return finished;
+}
+
+bool SimpleParallelChecksum::GetIdleDeadline( U64& deadline ) const
+{
+    if( mIdleGapSamples == 0 || !mRunActive )
+        return false;
+    deadline = mPreviousStartingSample + mIdleGapSamples;
+    return true;
+}
+
+bool SimpleParallelChecksum::CloseRun( RunResult& result )
+{
+    if( !mRunActive )
+        return false;
+    mRunActive = false;
+    return FinishRun( result );
+}
+
+void SimpleParallelChecksum::StartRun( U64 starting_sample )
+{
+    mRunActive = true;
+    mRunStartingSample = starting_sample;
+    mRunEndingSample = starting_sample;
+    mRunWords = 0;
+    mPendingIndex = 0;
+    mValue = mInitialValue;
+}
+
+bool SimpleParallelChecksum::FinishRun( RunResult& result )
+{
+    // a run needs at least one payload word besides the checksum.
+    if( mRunWords <= mChecksumWords )
+        return false;
+
+    U64 expected = 0;
+    for( U32 i = 0; i < mChecksumWords; i++ )
+    {
+        expected = ( expected << ( 8 * mBytesPerWord ) ) | mPendingWords[ ( mPendingIndex + i ) % mChecksumWords ];
+    }
+
+    result.mStartingSample = mRunStartingSample;
+    result.mEndingSample = mRunEndingSample;
+    result.mNumWords = mRunWords;
+    result.mExpected = static_cast<U32>( expected & ( ( 1ull << ( 8 * mChecksumBytes ) ) - 1 ) );
+    result.mComputed = GetComputedValue();
+    return true;
+}
+
+void SimpleParallelChecksum::Update( U16 word )
+{
+    switch( mType )
+    {
+    case ParallelChecksumType::None:
+        break;
+    case ParallelChecksumType::Sum8:
+        mValue += ( word >> 8 ) + ( word & 0xFF );
+        break;
+    case ParallelChecksumType::Sum16:
+        mValue += word;
+        break;
+    case ParallelChecksumType::Crc16CcittFalse:
+        if( mBytesPerWord == 1 )
+        {
+            mValue = ( ( mValue << 8 ) ^ mTables[ 0 ][ ( ( mValue >> 8 ) ^ word ) & 0xFF ] ) & 0xFFFF;
+        }
+        else
+        {
+            U32 x = mValue ^ word;
+            mValue = mTables[ 1 ][ ( x >> 8 ) & 0xFF ] ^ mTables[ 0 ][ x & 0xFF ];
+        }
+        break;
+    case ParallelChecksumType::Crc32:
+        if( mBytesPerWord == 1 )
+        {
+            mValue = ( mValue >> 8 ) ^ mTables[ 0 ][ ( mValue ^ word ) & 0xFF ];
+        }
+        else
+        {
+            // the register is reflected, so the most significant byte of the word goes into the low byte.
+            U32 x = mValue ^ ( ( word >> 8 ) | ( ( word & 0xFF ) << 8 ) );
+            mValue = ( x >> 16 ) ^ mTables[ 1 ][ x & 0xFF ] ^ mTables[ 0 ][ ( x >> 8 ) & 0xFF ];
+        }
+        break;
+    }
+}
+
+U32 SimpleParallelChecksum::GetComputedValue() const
+{
+    switch( mType )
+    {
+    case ParallelChecksumType::Sum8:
+        return mValue & 0xFF;
+    case ParallelChecksumType::Sum16:
+        return mValue & 0xFFFF;
+    case ParallelChecksumType::Crc32:
+        return mValue ^ 0xFFFFFFFF;
+    default:
+        return mValue;
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef SIMPLEPARALLEL_CHECKSUM
+#define SIMPLEPARALLEL_CHECKSUM
+
+#include "SimpleParallelAnalyzerSettings.h"
+#include <vector>
+
+// Verifies a checksum over runs of words, incrementally, as the words are decoded.
+// A run starts at the configured start word, or at the first word after an idle gap. The last words of a run carry the expected checksum,
+// most significant word first. Words are fed to the checksum most significant byte first.
+// CRCs use slicing tables sized for the bus width, so every word costs one table step, whether it holds 1 or 2 bytes.
+class SimpleParallelChecksum
+{
+  public:
+    struct RunResult
+    {
+        U64 mStartingSample;
+        U64 mEndingSample;
+        U64 mNumWords; // including the checksum words.
+        U32 mExpected;
+        U32 mComputed;
+    };
+
+    SimpleParallelChecksum();
+
+    void Setup( ParallelChecksumType type, U32 bytes_per_word, S64 start_word, U64 idle_gap_samples );
+    bool IsEnabled() const;
+
+    // returns true, and fills in result, when this word closes the previous run.
+    bool AddWord( U16 word, U64 starting_sample, U64 ending_sample, RunResult& result );
+
+    // returns true, and sets deadline, while a run is open that an idle gap would close. The gap has elapsed once there is no active clock
+    // edge up to and including the deadline sample.
+    bool GetIdleDeadline( U64& deadline ) const;
+
+    // closes the open run, once the caller knows its idle gap has elapsed. Returns true, and fills in result, if the run had a checksum.
+    bool CloseRun( RunResult& result );
+
+  protected:
+    void StartRun( U64 starting_sample );
+    bool FinishRun( RunResult& result );
+    void Update( U16 word );
+    U32 GetComputedValue() const;
+
+    ParallelChecksumType mType;
+    U32 mBytesPerWord;
+    S64 mStartWord;
+    U64 mIdleGapSamples;
+
+    U32 mChecksumBytes;
+    U32 mChecksumWords;
+    U32 mInitialValue;
+    U32 mTables[ 2 ][ 256 ];
+
+    // the newest mChecksumWords words of the run are held back, since they might be the checksum itself.
+    std::vector<U16> mPendingWords;
+    U32 mPendingIndex;
+
+    bool mRunActive;
+    U64 mRunStartingSample;
+    U64 mRunEndingSample;
+    U64 mRunWords;
+    U64 mPreviousStartingSample;
+    bool mHasPreviousWord;
+    U32 mValue;
+};
+
+#endif // SIMPLEPARALLEL_CHECKSUM
@@ -0,0 +1,161 @@
+#include "SimpleParallelEdgeCache.h"
+#include <algorithm>
+
+namespace
+{
+    const size_t MaxEncodedBytes = 256 * 1024 * 1024;
+    const size_t MaxTransitionBytes = 10 + 3; // varint of a U64 delta, and varint of a U16 state.
+}
+
+const U64 SimpleParallelEdgeCache::NoEdge;
+
+SimpleParallelEdgeCache::SimpleParallelEdgeCache()
+    : mSampleRate( 0 ), mInitialClockState( BIT_LOW ), mInitialLineState( 0 ), mFirstSample( 0 ), mFull( false )
+{
+}
+
+void SimpleParallelEdgeCache::Start( const Channel& clock, const std::vector<Channel>& lines, U32 sample_rate,
+                                     BitState initial_clock_state, U16 initial_line_state )
+{
+    Clear();
+    mClock = clock;
+    mLines = lines;
+    mSampleRate = sample_rate;
+    mInitialClockState = initial_clock_state;
+    mInitialLineState = initial_line_state;
+    mLineFirstEdges.assign( lines.size(), NoEdge );
+}
+
+void SimpleParallelEdgeCache::Clear()
+{
+    mClock = UNDEFINED_CHANNEL;
+    mLines.clear();
+    mLineFirstEdges.clear();
+    mSampleRate = 0;
+    mFirstSample = 0;
+    mEncoded.clear();
+    mEnd = Cursor();
+    mFull = false;
+}
+
+void SimpleParallelEdgeCache::SetLineFirstEdge( U32 line, U64 sample )
+{
+    mLineFirstEdges[ line ] = sample;
+}
+
+U64 SimpleParallelEdgeCache::GetLineFirstEdge( U32 line ) const
+{
+    return mLineFirstEdges[ line ];
+}
+
+bool SimpleParallelEdgeCache::AddTransition( U64 sample, U16 line_state )
+{
+    if( mFull || mEncoded.size() + MaxTransitionBytes > MaxEncodedBytes )
+    {
+        mFull = true;
+        return false;
+    }
+
+    if( mEnd.mNumTransitions == 0 )
+        mFirstSample = sample;
+
+    AppendVarint( sample - mEnd.mSample );
+    AppendVarint( line_state ^ mEnd.mLineState );
+
+    mEnd.mOffset = mEncoded.size();
+    mEnd.mNumTransitions++;
+    mEnd.mSample = sample;
+    mEnd.mLineState = line_state;
+    return true;
+}
+
+bool SimpleParallelEdgeCache::Matches( const Channel& clock, const std::vector<Channel>& data_channels, U32 sample_rate ) const
+{
+    if( IsEmpty() || clock != mClock || sample_rate != mSampleRate )
+        return false;
+
+    for( auto& channel : data_channels )
+    {
+        if( std::find( mLines.begin(), mLines.end(), channel ) == mLines.end() )
+            return false;
+    }
+    return true;
+}
+
+bool SimpleParallelEdgeCache::IsEmpty() const
+{
+    return mEnd.mNumTransitions == 0;
+}
+
+bool SimpleParallelEdgeCache::IsFull() const
+{
+    return mFull;
+}
+
+U64 SimpleParallelEdgeCache::GetFirstSample() const
+{
+    return mFirstSample;
+}
+
+U64 SimpleParallelEdgeCache::GetLastSample() const
+{
+    return mEnd.mSample;
+}
+
+BitState SimpleParallelEdgeCache::GetInitialClockState() const
+{
+    return mInitialClockState;
+}
+
+U16 SimpleParallelEdgeCache::GetInitialLineState() const
+{
+    return mInitialLineState;
+}
+
+const std::vector<Channel>& SimpleParallelEdgeCache::GetLines() const
+{
+    return mLines;
+}
+
+bool SimpleParallelEdgeCache::Read( Cursor& cursor ) const
+{
+    if( cursor.mOffset >= mEnd.mOffset )
+        return false;
+
+    const U8* data = mEncoded.data();
+    size_t offset = cursor.mOffset;
+
+    U64 delta = 0;
+    for( U32 shift = 0;; shift += 7 )
+    {
+        U8 byte = data[ offset++ ];
+        delta |= static_cast<U64>( byte & 0x7F ) << shift;
+        if( ( byte & 0x80 ) == 0 )
+            break;
+    }
+
+    U32 state_change = 0;
+    for( U32 shift = 0;; shift += 7 )
+    {
+        U8 byte = data[ offset++ ];
+        state_change |= static_cast<U32>( byte & 0x7F ) << shift;
+        if( ( byte & 0x80 ) == 0 )
+            break;
+    }
+
+    cursor.mOffset = offset;
+    cursor.mNumTransitions++;
+    cursor.mSample += delta;
+    cursor.mLineState ^= static_cast<U16>( state_change );
+    return true;
+}
+
+void SimpleParallelEdgeCache::AppendVarint( U64 value )
+{
+    while( value >= 0x80 )
+    {
+        mEncoded.push_back( static_cast<U8>( value | 0x80 ) );
+        value >>= 7;
+    }
+    mEncoded.push_back( static_cast<U8>( value ) );
+}
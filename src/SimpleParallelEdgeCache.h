@@ -0,0 +1,69 @@
+#ifndef SIMPLEPARALLEL_EDGE_CACHE
+#define SIMPLEPARALLEL_EDGE_CACHE
+
+#include <LogicPublicTypes.h>
+#include <vector>
+
+// Records every clock transition of a run, and the state of the data lines sampled at it, so a later run with different decode settings
+// can rebuild its frames in one linear scan instead of walking the channels again.
+// Transitions are delta encoded: each one is stored as a varint of the sample delta to the previous transition, followed by a varint of
+// the line state XOR the previous line state. A steady bus costs 2 to 4 bytes per transition.
+class SimpleParallelEdgeCache
+{
+  public:
+    // a position in the encoded transitions. Reading resumes from here.
+    struct Cursor
+    {
+        size_t mOffset = 0;
+        U64 mNumTransitions = 0;
+        U64 mSample = 0;
+        U16 mLineState = 0;
+    };
+
+    static const U64 NoEdge = ~0ull;
+
+    SimpleParallelEdgeCache();
+
+    // discards all transitions, and starts recording for a new set of channels.
+    void Start( const Channel& clock, const std::vector<Channel>& lines, U32 sample_rate, BitState initial_clock_state,
+                U16 initial_line_state );
+    void Clear();
+
+    // the first edge of each line identifies the capture, along with the clock. It is set once known, while recording.
+    void SetLineFirstEdge( U32 line, U64 sample );
+    U64 GetLineFirstEdge( U32 line ) const; // NoEdge if the line has no edge up to the last recorded transition.
+
+    // returns false once the cache is full. The transitions recorded so far stay valid.
+    bool AddTransition( U64 sample, U16 line_state );
+
+    // true if the cache was recorded at this sample rate, on this clock, and sampled every line in data_channels.
+    bool Matches( const Channel& clock, const std::vector<Channel>& data_channels, U32 sample_rate ) const;
+
+    bool IsEmpty() const;
+    bool IsFull() const;
+    U64 GetFirstSample() const;
+    U64 GetLastSample() const;
+    BitState GetInitialClockState() const;
+    U16 GetInitialLineState() const;
+    const std::vector<Channel>& GetLines() const;
+
+    // reads the transition at the cursor, and advances it. Returns false at the end of the cache.
+    bool Read( Cursor& cursor ) const;
+
+  protected:
+    void AppendVarint( U64 value );
+
+    Channel mClock;
+    std::vector<Channel> mLines; // bit i of every line state is mLines[ i ].
+    U32 mSampleRate;
+    BitState mInitialClockState;
+    U16 mInitialLineState;
+    std::vector<U64> mLineFirstEdges;
+    U64 mFirstSample;
+
+    std::vector<U8> mEncoded;
+    Cursor mEnd;
+    bool mFull;
+};
+
+#endif // SIMPLEPARALLEL_EDGE_CACHE
@@ -0,0 +1,314 @@
+#include "SimpleParallelFrameStream.h"
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const U64 RingCapacity = 1 << 16; // must be a power of 2.
+    const U64 MaxRecordsPerWrite = 1024;
+    const std::chrono::milliseconds MinReconnectInterval( 250 );
+    const std::chrono::milliseconds MaxReconnectInterval( 8000 );
+    const U32 WriteTimeoutMs = 100; // how often a blocked write checks whether the stream is stopping.
+
+    void AppendLittleEndian( std::vector<U8>& buffer, U64 value, U32 num_bytes )
+    {
+        for( U32 i = 0; i < num_bytes; i++ )
+        {
+            buffer.push_back( static_cast<U8>( value >> ( 8 * i ) ) );
+        }
+    }
+}
+
+SimpleParallelFrameStream::SimpleParallelFrameStream( const std::string& path, U64 run_number, U32 sample_rate )
+    : mPath( path ),
+      mRunNumber( run_number ),
+      mSampleRate( sample_rate ),
+      mRing( RingCapacity ),
+      mRingMask( RingCapacity - 1 ),
+      mHead( 0 ),
+      mTail( 0 ),
+      mDroppedCount( 0 ),
+      mStop( false ),
+      mDrainSleeping( false )
+{
+#ifdef _WIN32
+    mPipe = nullptr;
+    mWriteEvent = CreateEventA( NULL, TRUE, FALSE, NULL );
+#else
+    mSocket = -1;
+#endif
+    mThread = std::thread( &SimpleParallelFrameStream::DrainThread, this );
+}
+
+SimpleParallelFrameStream::~SimpleParallelFrameStream()
+{
+    {
+        std::lock_guard<std::mutex> lock( mWakeMutex );
+        mStop.store( true );
+    }
+    mWake.notify_one();
+    mThread.join();
+    Disconnect();
+#ifdef _WIN32
+    if( mWriteEvent != nullptr )
+        CloseHandle( mWriteEvent );
+#endif
+}
+
+void SimpleParallelFrameStream::Push( U64 starting_sample, U64 ending_sample, U16 value )
+{
+    U64 head = mHead.load( std::memory_order_relaxed );
+    if( head - mTail.load( std::memory_order_acquire ) > mRingMask )
+    {
+        // the ring buffer is full. Never wait for the consumer, drop the frame instead.
+        mDroppedCount.fetch_add( 1, std::memory_order_relaxed );
+        return;
+    }
+
+    Record& record = mRing[ head & mRingMask ];
+    record.mStartingSample = starting_sample;
+    record.mEndingSample = ending_sample;
+    record.mDroppedCount = static_cast<U32>( std::min<U64>( mDroppedCount.load( std::memory_order_relaxed ), 0xFFFFFFFF ) );
+    record.mValue = value;
+
+    // mHead and mDrainSleeping are both sequentially consistent, so either the drain thread sees the new head before it sleeps, or we
+    // see that it is sleeping and wake it.
+    mHead.store( head + 1 );
+    if( mDrainSleeping.load() )
+    {
+        std::lock_guard<std::mutex> lock( mWakeMutex );
+        mWake.notify_one();
+    }
+}
+
+U64 SimpleParallelFrameStream::GetDroppedCount() const
+{
+    return mDroppedCount.load( std::memory_order_relaxed );
+}
+
+void SimpleParallelFrameStream::DrainThread()
+{
+    std::vector<U8> buffer;
+    buffer.reserve( MaxRecordsPerWrite * RecordSize );
+
+    bool connected = false;
+    auto reconnect_interval = MinReconnectInterval;
+
+    while( !mStop.load() )
+    {
+        if( !connected )
+        {
+            connected = Connect();
+            if( connected )
+            {
+                reconnect_interval = MinReconnectInterval;
+
+                buffer.clear();
+                AppendLittleEndian( buffer, mRunNumber, 8 );
+                AppendLittleEndian( buffer, mSampleRate, 8 );
+                AppendLittleEndian( buffer, 0, 4 );
+                AppendLittleEndian( buffer, 0, 2 );
+                AppendLittleEndian( buffer, RunStartRecord, 2 );
+                if( !Write( buffer.data(), buffer.size() ) )
+                {
+                    Disconnect();
+                    connected = false;
+                }
+            }
+
+            if( !connected )
+            {
+                // nobody is listening. Discard what was pushed in the meantime, so a consumer that connects later gets current frames.
+                U64 tail = mTail.load( std::memory_order_relaxed );
+                U64 head = mHead.load( std::memory_order_acquire );
+                if( head != tail )
+                {
+                    mDroppedCount.fetch_add( head - tail, std::memory_order_relaxed );
+                    mTail.store( head, std::memory_order_release );
+                }
+
+                // back off, so a consumer that never shows up costs next to nothing.
+                std::unique_lock<std::mutex> lock( mWakeMutex );
+                mWake.wait_for( lock, reconnect_interval, [&]() { return mStop.load(); } );
+                reconnect_interval = std::min( reconnect_interval * 2, MaxReconnectInterval );
+                continue;
+            }
+        }
+
+        U64 tail = mTail.load( std::memory_order_relaxed );
+        U64 head = mHead.load( std::memory_order_acquire );
+
+        if( head == tail )
+        {
+            // sleep until Push wakes us, or we are stopped. Once the capture is done, this thread stays asleep.
+            std::unique_lock<std::mutex> lock( mWakeMutex );
+            mDrainSleeping.store( true );
+            mWake.wait( lock, [&]() { return mStop.load() || mHead.load() != tail; } );
+            mDrainSleeping.store( false );
+            continue;
+        }
+
+        U64 count = std::min<U64>( head - tail, MaxRecordsPerWrite );
+        buffer.clear();
+        for( U64 i = 0; i < count; i++ )
+        {
+            const Record& record = mRing[ ( tail + i ) & mRingMask ];
+            AppendLittleEndian( buffer, record.mStartingSample, 8 );
+            AppendLittleEndian( buffer, record.mEndingSample, 8 );
+            AppendLittleEndian( buffer, record.mDroppedCount, 4 );
+            AppendLittleEndian( buffer, record.mValue, 2 );
+            AppendLittleEndian( buffer, FrameRecord, 2 );
+        }
+        // the records have been copied out, hand the slots back to the producer before the (possibly slow) write.
+        mTail.store( tail + count, std::memory_order_release );
+
+        if( !Write( buffer.data(), buffer.size() ) )
+        {
+            Disconnect();
+            connected = false;
+        }
+    }
+}
+
+#ifdef _WIN32
+
+bool SimpleParallelFrameStream::Connect()
+{
+    // writes are overlapped, so a stalled consumer can't keep the destructor from joining this thread.
+    if( mWriteEvent == nullptr )
+        return false;
+    HANDLE pipe = CreateFileA( mPath.c_str(), GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL );
+    if( pipe == INVALID_HANDLE_VALUE )
+        return false;
+    mPipe = pipe;
+    return true;
+}
+
+void SimpleParallelFrameStream::Disconnect()
+{
+    if( mPipe != nullptr )
+    {
+        CloseHandle( mPipe );
+        mPipe = nullptr;
+    }
+}
+
+bool SimpleParallelFrameStream::Write( const U8* data, size_t length )
+{
+    while( length > 0 )
+    {
+        if( mStop.load() )
+            return false;
+        DWORD written = 0;
+        DWORD chunk = static_cast<DWORD>( std::min<size_t>( length, MAXDWORD ) );
+        OVERLAPPED overlapped;
+        memset( &overlapped, 0, sizeof( overlapped ) );
+        overlapped.hEvent = mWriteEvent;
+        if( !WriteFile( mPipe, data, chunk, NULL, &overlapped ) && GetLastError() != ERROR_IO_PENDING )
+            return false;
+
+        // like SO_SNDTIMEO on the socket, wait in bounded steps and give up once we are stopped. A cancelled write must still complete
+        // before overlapped goes out of scope.
+        for( ;; )
+        {
+            DWORD wait_result = WaitForSingleObject( mWriteEvent, WriteTimeoutMs );
+            if( wait_result == WAIT_OBJECT_0 )
+                break;
+            if( wait_result != WAIT_TIMEOUT || mStop.load() )
+            {
+                CancelIoEx( mPipe, &overlapped );
+                GetOverlappedResult( mPipe, &overlapped, &written, TRUE );
+                return false;
+            }
+        }
+        if( !GetOverlappedResult( mPipe, &overlapped, &written, FALSE ) )
+            return false;
+        data += written;
+        length -= written;
+    }
+    return true;
+}
+
+#else
+
+bool SimpleParallelFrameStream::Connect()
+{
+    sockaddr_un address;
+    memset( &address, 0, sizeof( address ) );
+    address.sun_family = AF_UNIX;
+    if( mPath.empty() || mPath.size() >= sizeof( address.sun_path ) )
+        return false;
+    strncpy( address.sun_path, mPath.c_str(), sizeof( address.sun_path ) - 1 );
+
+    int s = socket( AF_UNIX, SOCK_STREAM, 0 );
+    if( s < 0 )
+        return false;
+
+    if( connect( s, reinterpret_cast<sockaddr*>( &address ), sizeof( address ) ) != 0 )
+    {
+        close( s );
+        return false;
+    }
+
+    // bound every send, so a stalled consumer can't keep the destructor from joining this thread.
+    timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = WriteTimeoutMs * 1000;
+    setsockopt( s, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof( timeout ) );
+#ifdef SO_NOSIGPIPE
+    int no_sigpipe = 1;
+    setsockopt( s, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof( no_sigpipe ) );
+#endif
+
+    mSocket = s;
+    return true;
+}
+
+void SimpleParallelFrameStream::Disconnect()
+{
+    if( mSocket >= 0 )
+    {
+        close( mSocket );
+        mSocket = -1;
+    }
+}
+
+bool SimpleParallelFrameStream::Write( const U8* data, size_t length )
+{
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+
+    while( length > 0 )
+    {
+        if( mStop.load() )
+            return false;
+        ssize_t sent = send( mSocket, data, length, flags );
+        if( sent < 0 )
+        {
+            if( errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR )
+                continue;
+            return false;
+        }
+        data += sent;
+        length -= sent;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef SIMPLEPARALLEL_FRAME_STREAM
+#define SIMPLEPARALLEL_FRAME_STREAM
+
+#include <LogicPublicTypes.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Streams committed frames to a local consumer while the capture is being decoded.
+// The analyzer worker thread pushes frames into a single-producer, single-consumer ring buffer, and never waits for the consumer.
+// A background thread drains the ring buffer into a Unix domain socket (or a named pipe on Windows), created and listened on by the
+// consumer.
+// If the consumer is missing or too slow, frames are dropped and counted instead.
+//
+// Every record is 24 bytes, little-endian, and ends with a U16 record type. Each connection starts with a run start record:
+//   U64 run number, U64 sample rate in Hz, U32 reserved (0), U16 reserved (0), U16 type (1).
+// A new run number means the capture was decoded again, so sample numbers start over. Each frame is then sent as:
+//   U64 starting sample, U64 ending sample, U32 total dropped frames so far, U16 data word, U16 type (0).
+class SimpleParallelFrameStream
+{
+  public:
+    SimpleParallelFrameStream( const std::string& path, U64 run_number, U32 sample_rate );
+    ~SimpleParallelFrameStream();
+
+    // only call from the analyzer worker thread.
+    void Push( U64 starting_sample, U64 ending_sample, U16 value );
+    U64 GetDroppedCount() const;
+
+    static const U32 RecordSize = 24;
+    static const U16 FrameRecord = 0;
+    static const U16 RunStartRecord = 1;
+
+  protected:
+    struct Record
+    {
+        U64 mStartingSample;
+        U64 mEndingSample;
+        U32 mDroppedCount;
+        U16 mValue;
+    };
+
+    void DrainThread();
+    bool Connect();
+    void Disconnect();
+    bool Write( const U8* data, size_t length );
+
+    std::string mPath;
+    U64 mRunNumber;
+    U32 mSampleRate;
+
+    // mHead is only written by Push, and mTail is only written by DrainThread. Both count records, and wrap with the capacity mask.
+    std::vector<Record> mRing;
+    U64 mRingMask;
+    std::atomic<U64> mHead;
+    std::atomic<U64> mTail;
+    std::atomic<U64> mDroppedCount;
+
+    std::atomic<bool> mStop;
+    std::thread mThread;
+
+    // the drain thread sleeps on mWake while there is nothing to send. Push only takes mWakeMutex when mDrainSleeping is set, which
+    // happens at most once per idle period.
+    std::mutex mWakeMutex;
+    std::condition_variable mWake;
+    std::atomic<bool> mDrainSleeping;
+
+#ifdef _WIN32
+    void* mPipe;
+    void* mWriteEvent; // signaled when an overlapped write to mPipe completes.
+#else
+    int mSocket;
+#endif
+};
+
+#endif // SIMPLEPARALLEL_FRAME_STREAM
@@ -0,0 +1,175 @@
+#include "SimpleParallelSequenceMatcher.h"
+#include <algorithm>
+#include <map>
+
+SimpleParallelSequenceMatcher::SimpleParallelSequenceMatcher() : mNumSymbols( 0 ), mState( 0 )
+{
+}
+
+void SimpleParallelSequenceMatcher::Build( const std::vector<std::vector<U16>>& sequences )
+{
+    mSymbolOfWord.clear();
+    mChildOffsets.clear();
+    mChildSymbols.clear();
+    mChildStates.clear();
+    mFailure.clear();
+    mTransitions.clear();
+    mMatches.clear();
+    mSequenceLengths.clear();
+    mNumSymbols = 0;
+    mState = 0;
+
+    if( sequences.empty() )
+        return;
+
+    // assign a symbol to every distinct word used by the sequences.
+    mSymbolOfWord.assign( 0x10000, 0 );
+    mNumSymbols = 1;
+    for( auto& sequence : sequences )
+    {
+        for( U16 word : sequence )
+        {
+            if( mSymbolOfWord[ word ] == 0 )
+                mSymbolOfWord[ word ] = mNumSymbols++;
+        }
+    }
+
+    // build the trie. State 0 is the root.
+    std::vector<std::map<U32, U32>> children( 1 );
+    mMatches.resize( 1 );
+    for( U32 i = 0; i < sequences.size(); i++ )
+    {
+        U32 state = 0;
+        for( U16 word : sequences[ i ] )
+        {
+            U32 symbol = mSymbolOfWord[ word ];
+            auto child = children[ state ].find( symbol );
+            if( child == children[ state ].end() )
+            {
+                U32 new_state = children.size();
+                children[ state ][ symbol ] = new_state;
+                children.emplace_back();
+                mMatches.emplace_back();
+                state = new_state;
+            }
+            else
+            {
+                state = child->second;
+            }
+        }
+        mMatches[ state ].push_back( i );
+        mSequenceLengths.push_back( sequences[ i ].size() );
+    }
+
+    // flatten the trie into sparse rows.
+    U32 num_states = children.size();
+    mChildOffsets.reserve( num_states + 1 );
+    for( auto& state_children : children )
+    {
+        mChildOffsets.push_back( mChildSymbols.size() );
+        for( auto& child : state_children )
+        {
+            mChildSymbols.push_back( child.first );
+            mChildStates.push_back( child.second );
+        }
+    }
+    mChildOffsets.push_back( mChildSymbols.size() );
+
+    // breadth first, fill in the failure links, and the matches inherited through them.
+    mFailure.assign( num_states, 0 );
+    std::vector<U32> queue;
+    queue.reserve( num_states );
+    queue.push_back( 0 );
+    for( U32 next = 0; next < queue.size(); next++ )
+    {
+        U32 state = queue[ next ];
+        for( U32 i = mChildOffsets[ state ]; i < mChildOffsets[ state + 1 ]; i++ )
+        {
+            U32 symbol = mChildSymbols[ i ];
+            U32 child = mChildStates[ i ];
+            queue.push_back( child );
+
+            if( state != 0 )
+            {
+                U32 failure = mFailure[ state ];
+                U32 target;
+                while( !FindChild( failure, symbol, target ) && failure != 0 )
+                    failure = mFailure[ failure ];
+                if( FindChild( failure, symbol, target ) )
+                    mFailure[ child ] = target;
+            }
+
+            auto& inherited = mMatches[ mFailure[ child ] ];
+            mMatches[ child ].insert( mMatches[ child ].end(), inherited.begin(), inherited.end() );
+        }
+    }
+
+    // collapse the failure links into a dense table, if it is small enough. Failure states are shallower, so their rows are done first.
+    if( static_cast<U64>( num_states ) * mNumSymbols * sizeof( U32 ) > MaxDenseTableBytes )
+        return;
+
+    mTransitions.assign( static_cast<size_t>( num_states ) * mNumSymbols, 0 );
+    for( U32 state : queue )
+    {
+        U32* transitions = &mTransitions[ static_cast<size_t>( state ) * mNumSymbols ];
+        if( state != 0 )
+        {
+            const U32* failure_transitions = &mTransitions[ static_cast<size_t>( mFailure[ state ] ) * mNumSymbols ];
+            std::copy( failure_transitions, failure_transitions + mNumSymbols, transitions );
+        }
+        for( U32 i = mChildOffsets[ state ]; i < mChildOffsets[ state + 1 ]; i++ )
+            transitions[ mChildSymbols[ i ] ] = mChildStates[ i ];
+    }
+}
+
+void SimpleParallelSequenceMatcher::Reset()
+{
+    mState = 0;
+}
+
+bool SimpleParallelSequenceMatcher::IsEmpty() const
+{
+    return mSequenceLengths.empty();
+}
+
+U32 SimpleParallelSequenceMatcher::GetSequenceLength( U32 sequence ) const
+{
+    return mSequenceLengths[ sequence ];
+}
+
+U32 SimpleParallelSequenceMatcher::GetMaxSequenceLength() const
+{
+    U32 max_length = 0;
+    for( U32 length : mSequenceLengths )
+        max_length = std::max( max_length, length );
+    return max_length;
+}
+
+U32 SimpleParallelSequenceMatcher::AdvanceSparse( U32 symbol ) const
+{
+    // words not used by any sequence always return to the root.
+    if( symbol == 0 )
+        return 0;
+
+    U32 state = mState;
+    U32 child;
+    for( ;; )
+    {
+        if( FindChild( state, symbol, child ) )
+            return child;
+        if( state == 0 )
+            return 0;
+        state = mFailure[ state ];
+    }
+}
+
+bool SimpleParallelSequenceMatcher::FindChild( U32 state, U32 symbol, U32& child ) const
+{
+    auto begin = mChildSymbols.begin() + mChildOffsets[ state ];
+    auto end = mChildSymbols.begin() + mChildOffsets[ state + 1 ];
+    auto found = std::lower_bound( begin, end, symbol );
+    if( found == end || *found != symbol )
+        return false;
+    child = mChildStates[ found - mChildSymbols.begin() ];
+    return true;
+}
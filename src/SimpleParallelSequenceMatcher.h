@@ -0,0 +1,55 @@
+#ifndef SIMPLEPARALLEL_SEQUENCE_MATCHER
+#define SIMPLEPARALLEL_SEQUENCE_MATCHER
+
+#include <LogicPublicTypes.h>
+#include <vector>
+
+// Finds any number of word sequences in a word stream, one word at a time (Aho-Corasick).
+// When it fits in MaxDenseTableBytes, the automaton is compiled into a dense transition table over the words that appear in the sequences,
+// so Advance costs two table lookups per word. Larger automatons keep sparse rows, one sorted list of children per state, and follow
+// failure links on a mismatch. That is still constant time per word, amortized over the stream.
+class SimpleParallelSequenceMatcher
+{
+  public:
+    SimpleParallelSequenceMatcher();
+
+    void Build( const std::vector<std::vector<U16>>& sequences );
+    void Reset();
+    bool IsEmpty() const;
+
+    // feeds the next word, and returns the indexes of all sequences that end with this word.
+    const std::vector<U32>& Advance( U16 word )
+    {
+        U32 symbol = mSymbolOfWord[ word ];
+        if( !mTransitions.empty() )
+            mState = mTransitions[ mState * mNumSymbols + symbol ];
+        else
+            mState = AdvanceSparse( symbol );
+        return mMatches[ mState ];
+    }
+
+    U32 GetSequenceLength( U32 sequence ) const;
+    U32 GetMaxSequenceLength() const;
+
+    static const size_t MaxDenseTableBytes = 16 * 1024 * 1024;
+
+  protected:
+    U32 AdvanceSparse( U32 symbol ) const;
+    bool FindChild( U32 state, U32 symbol, U32& child ) const;
+
+    std::vector<U32> mSymbolOfWord; // maps every possible word to a symbol. Symbol 0 is any word not used by a sequence.
+    U32 mNumSymbols;
+
+    // sparse rows: the children of state s are mChildSymbols/mChildStates[ mChildOffsets[ s ] .. mChildOffsets[ s + 1 ] ), by symbol.
+    std::vector<U32> mChildOffsets;
+    std::vector<U32> mChildSymbols;
+    std::vector<U32> mChildStates;
+    std::vector<U32> mFailure;
+
+    std::vector<U32> mTransitions;          // dense table, mNumSymbols entries per state. Empty when sparse rows are used.
+    std::vector<std::vector<U32>> mMatches; // sequences matched on entering each state, including those found via failure links.
+    std::vector<U32> mSequenceLengths;
+    U32 mState;
+};
+
+#endif // SIMPLEPARALLEL_SEQUENCE_MATCHER